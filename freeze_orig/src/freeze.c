@@ -5,7 +5,7 @@
 #define	game_loop	for (i = 0; i < maxclients->value; i++)
 #define	team_loop	for (i = red; i < none; i++)
 #define	_team_loop	for (i = red; i <= none; i++)
-#define	map_loop	for (i = 0; i < 64; i++)
+#define	map_loop	for (i = 0; i < config.nummaps; i++)
 #define	far_off	100000000
 
 #define	hook_on	0x00000001
@@ -48,6 +48,11 @@
 #define	mapnohook	0x00000004
 #define	everyone_ready 0x00000008
 
+#define	flash_range	8192
+#define	flash_move	2
+#define	thaw_pad	16
+#define	thaw_decay	0.2
+
 cvar_t*	item_respawn_time;
 cvar_t*	hook_max_len;
 cvar_t*	hook_rpf;
@@ -62,14 +67,18 @@ cvar_t*	random_map;
 cvar_t*	vote_percent;
 cvar_t*	use_ready;
 cvar_t*	grapple_wall;
+cvar_t*	flashlight_traces;
 static char*	freeze_skin[] = {"ctf_r", "ctf_b", "ctf_g", "ctf_y", "ctf_r"};
 static char*	freeze_team_[] = {"RED", "BLUE", "GREEN", "YELLOW", "NONE"};
 static char*	freeze_team__[] = {"Red", "Blu", "Grn", "Ylw", "Non"};
 static int	gib_queue;
-static int	team_max_count;
 static int	moan[8];
-static int	lame_hack;
-static float	ready_time;
+static int	lame_hack;	// is_motd, end_vote, mapnohook
+static int	flash_queue[MAX_EDICTS];
+static int	flash_queued;
+static int	flash_frame;
+static int	flash_used;
+static int	flash_granted;
 
 static qboolean floodCheck(edict_t* ent)
 {
@@ -98,6 +107,58 @@ static qboolean floodCheck(edict_t* ent)
 	return false;
 }
 
+// the team score strings, eight to an arena
+#define	arena_cs(arena, team)	(CS_GENERAL + ((arena) - arenas) * 8 + (team))
+
+// to the players in one arena, or to everyone when there is only the one
+static void arenaPrintf(arenanode* arena, char* fmt, ...)
+{
+	va_list	argptr;
+	char	msg[1024];
+	int	i;
+	edict_t*	ent;
+
+	va_start(argptr, fmt);
+	vsnprintf(msg, sizeof(msg), fmt, argptr);
+	va_end(argptr);
+
+	if (numarenas == 1)
+	{
+		gi.bprintf(PRINT_HIGH, "%s", msg);
+		return;
+	}
+	game_loop
+	{
+		ent = g_edicts + 1 + i;
+		if (!ent->inuse || arena_of(ent) != arena)
+			continue;
+		gi.cprintf(ent, PRINT_HIGH, "%s", msg);
+	}
+	if (dedicated->value)
+		gi.cprintf(NULL, PRINT_HIGH, "[%d] %s", (int)(arena - arenas) + 1, msg);
+}
+
+static void arenaSound(arenanode* arena, char* sound)
+{
+	int	i;
+	edict_t*	ent;
+
+	if (numarenas == 1)
+	{
+		gi.positioned_sound(vec3_origin, world, CHAN_VOICE | CHAN_RELIABLE, gi.soundindex(sound), 1, ATTN_NONE, 0);
+		return;
+	}
+	game_loop
+	{
+		ent = g_edicts + 1 + i;
+		if (!ent->inuse || arena_of(ent) != arena)
+			continue;
+		gi.WriteByte(svc_stufftext);
+		gi.WriteString(va("play %s\n", sound));
+		gi.unicast(ent, true);
+	}
+}
+
 static void putInventory(char* s, edict_t* ent)
 {
 	gitem_t*	item = NULL;
@@ -126,8 +187,8 @@ void playerWeapon(edict_t* ent)
 
 	if (!ent->client->resp.spectator)
 	{
-		freeze[ent->client->resp.team].ready = false;
-		ready_time = far_off;
+		arena_of(ent)->freeze[ent->client->resp.team].ready = false;
+		arena_of(ent)->ready_time = far_off;
 	}
 
 	item = FindItem("blaster");
@@ -166,6 +227,7 @@ void cmdChange(edict_t* ent)
 {
 	char*	s;
 	int	team = none;
+	arenanode*	arena = arena_of(ent);
 
 	s = gi.argv(1);
 	if (!*s || ent->client->frozen)
@@ -177,16 +239,17 @@ void cmdChange(edict_t* ent)
 		team = red;
 	else if (Q_stricmp(s, "blue") == 0)
 		team = blue;
-	else if (Q_stricmp(s, "green") == 0 && team_max_count >= 3)
+	else if (Q_stricmp(s, "green") == 0 && arena->team_max_count >= 3)
 		team = green;
-	else if (Q_stricmp(s, "yellow") == 0 && team_max_count >= 4)
+	else if (Q_stricmp(s, "yellow") == 0 && arena->team_max_count >= 4)
 		team = yellow;
 	else if (Q_stricmp(s, "none") == 0 && !ent->client->resp.spectator)
 	{
 		gi.WriteByte(svc_stufftext);
 		gi.WriteString("spectator 1\n");
 		gi.unicast(ent, true);
-		freeze[ent->client->resp.team].update = true;
+		arena->freeze[ent->client->resp.team].update = true;
+		G_JournalEvent(JE_TEAM, ent, NULL, none, 0, 0);
 		return;
 	}
 	else
@@ -212,8 +275,9 @@ void cmdChange(edict_t* ent)
 		gi.WriteByte(svc_stufftext);
 		gi.WriteString("spectator 0\n");
 		gi.unicast(ent, true);
-		freeze[ent->client->resp.team].update = true;
+		arena->freeze[ent->client->resp.team].update = true;
 		ent->client->resp.team = team;
+		G_JournalEvent(JE_TEAM, ent, NULL, team, 0, 0);
 	}
 	else if (ent->client->resp.team == team)
 	{
@@ -222,13 +286,14 @@ void cmdChange(edict_t* ent)
 	}
 	else
 	{
-		freeze[ent->client->resp.team].update = true;
+		arena->freeze[ent->client->resp.team].update = true;
 		ent->client->resp.team = team;
+		G_JournalEvent(JE_TEAM, ent, NULL, team, 0, 0);
 		ent->flags &= ~FL_GODMODE;
 		ent->health = 0;
 		meansOfDeath = MOD_SUICIDE;
 		player_die(ent, ent, ent, 100000, vec3_origin);
-		gi.bprintf(PRINT_HIGH, "%s changed to the %s team.\n", ent->client->pers.netname, freeze_team[team]);
+		arenaPrintf(arena, "%s changed to the %s team.\n", ent->client->pers.netname, freeze_team[team]);
 	}
 }
 
@@ -240,11 +305,13 @@ qboolean playerDamage(edict_t* targ, edict_t* attacker, int damage)
 		return false;
 	if (!attacker->client)
 		return false;
+	if (targ->client->resp.arena != attacker->client->resp.arena)
+		return true;
 	if (targ->client->hookstate && random() < 0.2)
 		targ->client->hookstate = 0;
 	if (targ->health > 0)
 	{
-		if (!(lame_hack &everyone_ready))
+		if (!(arena_of(attacker)->lame_hack &everyone_ready))
 		{
 			if (!(attacker->client->resp.help &ready_help))
 			{
@@ -303,6 +370,87 @@ qboolean freezeCheck(edict_t* ent)
 	return true;
 }
 
+static void thawTouch(edict_t* self, edict_t* other, cplane_t* plane, csurface_t* surf)
+{
+	edict_t*	ent = self->owner;
+	int	j;
+	vec3_t	eorg;
+
+	if (!ent->inuse || !ent->client->frozen || ent->client->thaw_volume != self)
+		return;
+	if (!other->client || other == ent)
+		return;
+	if (other->client->resp.spectator)
+		return;
+	if (other->health <= 0)
+		return;
+	if (other->client->resp.team != ent->client->resp.team)
+		return;
+	if (other->client->resp.arena != ent->client->resp.arena)
+		return;
+	for (j = 0; j < 3; j++)
+		eorg[j] = ent->s.origin[j] - (other->s.origin[j] + (other->mins[j] + other->maxs[j]) * 0.5);
+	if (VectorLength(eorg) > MELEE_DISTANCE)
+		return;
+	if (!(other->client->resp.help &thaw_help))
+	{
+		other->client->showscores = false;
+		other->client->resp.help |= thaw_help;
+		gi.centerprintf(other, "Wait here a second to free them.");
+		gi.sound(other, CHAN_AUTO, gi.soundindex("misc/talk1.wav"), 1, ATTN_STATIC, 0);
+	}
+	ent->client->resp.thawer = other;
+	if (ent->client->thaw_time == far_off)
+	{
+		ent->client->thaw_time = level.time + 3;
+		gi.sound(ent, CHAN_BODY, gi.soundindex("world/steam3.wav"), 1, ATTN_NORM, 0);
+	}
+	self->touch_debounce_time = level.time;
+}
+
+static void thawThink(edict_t* self)
+{
+	edict_t*	ent = self->owner;
+
+	if (!ent->inuse || !ent->client->frozen || ent->client->thaw_volume != self)
+	{
+		G_FreeEdict(self);
+		return;
+	}
+	// nobody has been close for a while
+	if (ent->client->resp.thawer && level.time > self->touch_debounce_time + thaw_decay)
+	{
+		ent->client->resp.thawer = NULL;
+		ent->client->thaw_time = far_off;
+	}
+	if (!VectorCompare(self->s.origin, ent->s.origin))
+	{
+		VectorCopy(ent->s.origin, self->s.origin);
+		gi.linkentity(self);
+	}
+	self->nextthink = level.time + FRAMETIME;
+}
+
+static void thawVolume(edict_t* ent)
+{
+	edict_t*	volume;
+
+	volume = G_Spawn();
+	volume->classname = "thaw_volume";
+	volume->svflags = SVF_NOCLIENT;
+	volume->movetype = MOVETYPE_NONE;
+	volume->solid = SOLID_TRIGGER;
+	VectorSet(volume->mins, -MELEE_DISTANCE - thaw_pad, -MELEE_DISTANCE - thaw_pad, -MELEE_DISTANCE - thaw_pad);
+	VectorSet(volume->maxs, MELEE_DISTANCE + thaw_pad, MELEE_DISTANCE + thaw_pad, MELEE_DISTANCE + thaw_pad);
+	VectorCopy(ent->s.origin, volume->s.origin);
+	volume->owner = ent;
+	volume->touch = thawTouch;
+	volume->think = thawThink;
+	volume->nextthink = level.time + FRAMETIME;
+	gi.linkentity(volume);
+	ent->client->thaw_volume = volume;
+}
+
 void freezeAnim(edict_t* ent)
 {
 	ent->client->anim_priority = ANIM_DEATH;
@@ -366,16 +514,19 @@ void freezeAnim(edict_t* ent)
 	ent->client->frozen_time = level.time + frozen_time->value;
 	ent->client->resp.thawer = NULL;
 	ent->client->thaw_time = far_off;
+	thawVolume(ent);
 	if (random() > 0.3)
 		ent->client->hookstate -= ent->client->hookstate &(grow_on | shrink_on);
 	ent->deadflag = DEAD_DEAD;
 	gi.linkentity(ent);
 }
 
-qboolean gibCheck()
+qboolean gibCheck(edict_t* self)
 {
 	if (gib_queue > 35)
 		return true;
+	if (!G_EffectEntity(self->s.origin, FX_GIB))
+		return true;
 	else
 	{
 		gib_queue++;
@@ -395,14 +546,20 @@ static void playerView(edict_t* ent)
 	edict_t*	other;
 	vec3_t	ent_origin;
 	vec3_t	forward;
-	vec3_t	other_origin;
-	vec3_t	dist;
 	trace_t	trace;
 	float	dot;
 	float	other_dot;
 	edict_t*	best_other;
+	static bspray_t	rays[MAX_CLIENTS];
+	static edict_t*	others[MAX_CLIENTS];
+	int	numrays;
+	int	j;
+	static vec3_t	eyes[MAX_CLIENTS];
+	static edict_t*	candidates[MAX_CLIENTS];
+	float	values[MAX_CLIENTS];
+	int	count;
 
-	if (level.framenum &7)
+	if (level.framenum % BASEFRAMES(8))
 		return;
 
 	other_dot = 0.3;
@@ -411,6 +568,7 @@ static void playerView(edict_t* ent)
 	ent_origin[2] += ent->viewheight;
 	AngleVectors(ent->s.angles, forward, NULL, NULL);
 
+	count = 0;
 	game_loop
 	{
 		other = g_edicts + 1 + i;
@@ -424,20 +582,48 @@ static void playerView(edict_t* ent)
 			continue;
 		if (other->health <= 0 && !other->client->frozen)
 			continue;
-		VectorCopy(other->s.origin, other_origin);
-		other_origin[2] += other->viewheight;
-		VectorSubtract(other_origin, ent_origin, dist);
-		if (VectorLength(dist) > 800)
+		VectorCopy(other->s.origin, eyes[count]);
+		eyes[count][2] += other->viewheight;
+		candidates[count++] = other;
+	}
+
+	G_PointDistances(ent_origin, eyes, count, values);
+	numrays = 0;
+	for (j = 0; j < count; j++)
+	{
+		if (values[j] > 800 * 800)
+			continue;
+		VectorCopy(ent_origin, rays[numrays].start);
+		VectorCopy(eyes[j], rays[numrays].end);
+		others[numrays++] = candidates[j];
+	}
+
+	// walls hide most of them, and the workers can find those
+	G_BspTraceRays(rays, numrays, MASK_OPAQUE);
+
+	// the ones in sight, and which way they are
+	count = 0;
+	for (j = 0; j < numrays; j++)
+	{
+		if (rays[j].trace.fraction != 1)
 			continue;
-		trace = gi.trace(ent_origin, vec3_origin, vec3_origin, other_origin, ent, MASK_OPAQUE);
+		// doors and other brush models
+		trace = gi.trace(ent_origin, vec3_origin, vec3_origin, rays[j].end, ent, MASK_OPAQUE);
 		if (trace.fraction != 1)
 			continue;
-		VectorNormalize(dist);
-		dot = DotProduct(dist, forward);
+		VectorSubtract(rays[j].end, ent_origin, eyes[count]);
+		VectorNormalize(eyes[count]);
+		candidates[count++] = others[j];
+	}
+
+	G_DotProducts(forward, eyes, count, values);
+	for (j = 0; j < count; j++)
+	{
+		dot = values[j];
 		if (dot > other_dot)
 		{
 			other_dot = dot;
-			best_other = other;
+			best_other = candidates[j];
 		}
 	}
 	if (best_other)
@@ -446,49 +632,6 @@ static void playerView(edict_t* ent)
 		ent->client->viewed = NULL;
 }
 
-static void playerThaw(edict_t* ent)
-{
-	int	i;
-	edict_t*	other;
-	int	j;
-	vec3_t	eorg;
-
-	game_loop
-	{
-		other = g_edicts + 1 + i;
-		if (!other->inuse)
-			continue;
-		if (other->client->resp.spectator)
-			continue;
-		if (other == ent)
-			continue;
-		if (other->health <= 0)
-			continue;
-		if (other->client->resp.team != ent->client->resp.team)
-			continue;
-		for (j = 0; j < 3; j++)
-			eorg[j] = ent->s.origin[j] - (other->s.origin[j] + (other->mins[j] + other->maxs[j]) * 0.5);
-		if (VectorLength(eorg) > MELEE_DISTANCE)
-			continue;
-		if (!(other->client->resp.help &thaw_help))
-		{
-			other->client->showscores = false;
-			other->client->resp.help |= thaw_help;
-			gi.centerprintf(other, "Wait here a second to free them.");
-			gi.sound(other, CHAN_AUTO, gi.soundindex("misc/talk1.wav"), 1, ATTN_STATIC, 0);
-		}
-		ent->client->resp.thawer = other;
-		if (ent->client->thaw_time == far_off)
-		{
-			ent->client->thaw_time = level.time + 3;
-			gi.sound(ent, CHAN_BODY, gi.soundindex("world/steam3.wav"), 1, ATTN_NORM, 0);
-		}
-		return;
-	}
-	ent->client->resp.thawer = NULL;
-	ent->client->thaw_time = far_off;
-}
-
 static void playerBreak(edict_t* ent, int force)
 {
 	int	n;
@@ -526,7 +669,7 @@ static void playerBreak(edict_t* ent, int force)
 	ent->movetype = MOVETYPE_TOSS;
 	ThrowClientHead(ent, force);
 	ent->client->frozen = false;
-	freeze[ent->client->resp.team].update = true;
+	arena_of(ent)->freeze[ent->client->resp.team].update = true;
 	ent->client->ps.stats[STAT_CHASE] = 0;
 }
 
@@ -534,10 +677,11 @@ static void playerUnfreeze(edict_t* ent)
 {
 	if (level.time > ent->client->frozen_time && level.time > ent->client->respawn_time)
 	{
+		G_JournalEvent(JE_MELT, NULL, ent, ent->client->resp.team, 0, 0);
 		playerBreak(ent, 50);
 		return;
 	}
-	if (ent->waterlevel == 3 && !(level.framenum &3))
+	if (ent->waterlevel == 3 && !(level.framenum % BASEFRAMES(4)))
 		ent->client->frozen_time -= 0.15;
 	if (level.time > ent->client->thaw_time)
 	{
@@ -550,11 +694,12 @@ static void playerUnfreeze(edict_t* ent)
 		{
 			ent->client->resp.thawer->client->resp.score++;
 			ent->client->resp.thawer->client->resp.thawed++;
-			freeze[ent->client->resp.team].thawed++;
+			arena_of(ent)->freeze[ent->client->resp.team].thawed++;
+			G_JournalEvent(JE_THAW, ent->client->resp.thawer, ent, ent->client->resp.team, 0, 0);
 			if (rand() &1)
-				gi.bprintf(PRINT_HIGH, "%s thaws %s like a package of frozen peas.\n", ent->client->resp.thawer->client->pers.netname, ent->client->pers.netname);
+				arenaPrintf(arena_of(ent), "%s thaws %s like a package of frozen peas.\n", ent->client->resp.thawer->client->pers.netname, ent->client->pers.netname);
 			else
-				gi.bprintf(PRINT_HIGH, "%s evicts %s from their igloo.\n", ent->client->resp.thawer->client->pers.netname, ent->client->pers.netname);
+				arenaPrintf(arena_of(ent), "%s evicts %s from their igloo.\n", ent->client->resp.thawer->client->pers.netname, ent->client->pers.netname);
 			playerBreak(ent, 100);
 		}
 	}
@@ -565,13 +710,15 @@ static void playerMove(edict_t* ent)
 	int	i;
 	edict_t*	other;
 	vec3_t	forward;
-	float	dist;
 	int	j;
-	vec3_t	eorg;
+	static vec3_t	centers[MAX_CLIENTS];
+	static edict_t*	candidates[MAX_CLIENTS];
+	float	values[MAX_CLIENTS];
+	int	count;
 
 	if (ent->client->hookstate)
 		return;
-	AngleVectors(ent->s.angles, forward, NULL, NULL);
+	count = 0;
 	game_loop
 	{
 		other = g_edicts + 1 + i;
@@ -585,13 +732,24 @@ static void playerMove(edict_t* ent)
 			continue;
 		if (other->client->resp.team == ent->client->resp.team)
 			continue;
+		if (other->client->resp.arena != ent->client->resp.arena)
+			continue;
 		if (other->client->hookstate)
 			continue;
 		for (j = 0; j < 3; j++)
-			eorg[j] = ent->s.origin[j] - (other->s.origin[j] + (other->mins[j] + other->maxs[j]) * 0.5);
-		dist = VectorLength(eorg);
-		if (dist > MELEE_DISTANCE)
+			centers[count][j] = other->s.origin[j] + (other->mins[j] + other->maxs[j]) * 0.5;
+		candidates[count++] = other;
+	}
+	if (!count)
+		return;
+
+	G_PointDistances(ent->s.origin, centers, count, values);
+	AngleVectors(ent->s.angles, forward, NULL, NULL);
+	for (j = 0; j < count; j++)
+	{
+		if (values[j] > MELEE_DISTANCE * MELEE_DISTANCE)
 			continue;
+		other = candidates[j];
 		VectorScale(forward, 600, other->velocity);
 		other->velocity[2] = 200;
 		gi.linkentity(other);
@@ -606,10 +764,7 @@ void freezeMain(edict_t* ent)
 	if (ent->client->resp.spectator)
 		return;
 	if (ent->client->frozen)
-	{
-		playerThaw(ent);
 		playerUnfreeze(ent);
-	}
 	else if (ent->health > 0)
 		playerMove(ent);
 }
@@ -625,11 +780,12 @@ void freezeScore(edict_t* ent, edict_t* killer)
 	int	count, best_total, best_team;
 	int	x, y;
 	int	move_over;
-	char	string[1400];
-	int	stringlength;
+	char	string[1025];	// layouts are kept to 1024
+	strbuf_t	sb;
+	int	mark;
 	char*	tag;
-	char	entry[1024];
 	gclient_t*	cl;
+	arenanode*	arena = arena_of(ent);
 
 	_team_loop
 		total[i] = 0;
@@ -638,6 +794,8 @@ void freezeScore(edict_t* ent, edict_t* killer)
 		other = g_edicts + 1 + i;
 		if (!other->inuse)
 			continue;
+		if (arena_of(other) != arena)
+			continue;
 		if (other->client->resp.spectator)
 			team = none;
 		else
@@ -685,11 +843,12 @@ void freezeScore(edict_t* ent, edict_t* killer)
 			count += 3 + total[i];
 	move_over = (int)(count / 2) * 8;
 
-	string[0] = 0;
-	stringlength = strlen(string);
+	SB_Init(&sb, string, sizeof(string));
 
 	_team_loop
 	{
+		if (!total[i])
+			continue;
 		if (i == red)
 			tag = "k_redkey";
 		else if (i == blue)
@@ -699,21 +858,17 @@ void freezeScore(edict_t* ent, edict_t* killer)
 		else
 			tag = "k_powercube";
 
+		mark = sb.len;
 		if (i == none)
-			Com_sprintf(entry, sizeof(entry), "xv %d yv %d string \"%6.6s\" ", x, y, freeze_team_[i]);
+			SB_Printf(&sb, "xv %d yv %d string \"%6.6s\" ", x, y, freeze_team_[i]);
 		else
-			Com_sprintf(entry, sizeof(entry), "xv %d yv %d if %d picn %s endif string \"%6.6s Sco%3d Tha%3d\" ", x, y, 19 + i, tag, freeze_team_[i], freeze[i].score, freeze[i].thawed);
-		k = strlen(entry);
-		if (stringlength + k > 1024)
-			break;
-		if (total[i])
+			SB_Printf(&sb, "xv %d yv %d if %d picn %s endif string \"%6.6s Sco%3d Tha%3d\" ", x, y, 19 + i, tag, freeze_team_[i], arena->freeze[i].score, arena->freeze[i].thawed);
+		if (sb.overflowed)
 		{
-			strcpy(string + stringlength, entry);
-			stringlength += k;
-			y += 16;
+			SB_Truncate(&sb, mark);
+			break;
 		}
-		else
-			continue;
+		y += 16;
 		for (j = 0; j < total[i]; j++)
 		{
 			if (y >= 224)
@@ -725,22 +880,23 @@ void freezeScore(edict_t* ent, edict_t* killer)
 				y = 32;
 			}
 			cl = &game.clients[sorted[i][j]];
-			Com_sprintf(entry, sizeof(entry), "ctf %d %d %d %d %d ", x, y, sorted[i][j], cl->resp.score, level.intermissiontime ? cl->resp.thawed : (cl->ping > 999 ? 999 : cl->ping));
+			mark = sb.len;
+			SB_Printf(&sb, "ctf %d %d %d %d %d ", x, y, sorted[i][j], cl->resp.score, level.intermissiontime ? cl->resp.thawed : (cl->ping > 999 ? 999 : cl->ping));
 			if (cl->frozen)
-				sprintf(entry + strlen(entry), "xv %d yv %d string2 \"/\" ", x + 56, y);
-			k = strlen(entry);
-			if (stringlength + k > 1024)
+				SB_Printf(&sb, "xv %d yv %d string2 \"/\" ", x + 56, y);
+			if (sb.overflowed)
+			{
+				SB_Truncate(&sb, mark);
 				break;
-			strcpy(string + stringlength, entry);
-			stringlength += k;
+			}
 			y += 8;
 		}
-		Com_sprintf(entry, sizeof(entry), "xv %d yv %d string \"--------------------\" ", x, y);
-		k = strlen(entry);
-		if (stringlength + k > 1024)
+		mark = sb.len;
+		if (!SB_Printf(&sb, "xv %d yv %d string \"--------------------\" ", x, y))
+		{
+			SB_Truncate(&sb, mark);
 			break;
-		strcpy(string + stringlength, entry);
-		stringlength += k;
+		}
 		if (y >= 208 || (y >= move_over && x == 0))
 		{
 			if (x == 0)
@@ -757,18 +913,19 @@ void freezeScore(edict_t* ent, edict_t* killer)
 	gi.WriteString(string);
 }
 
-void freezeIntermission(void)
+
+static int arenaWinner(arenanode* arena)
 {
 	int	i, j, k;
 	int	team;
 
 	i = j = k = 0;
 	team_loop
-		if (freeze[i].score > j)
-			j = freeze[i].score;
+		if (arena->freeze[i].score > j)
+			j = arena->freeze[i].score;
 
 	team_loop
-		if (freeze[i].score == j)
+		if (arena->freeze[i].score == j)
 		{
 			k++;
 			team = i;
@@ -778,11 +935,11 @@ void freezeIntermission(void)
 	{
 		i = j = k = 0;
 		team_loop
-			if (freeze[i].thawed > j)
-				j = freeze[i].thawed;
+			if (arena->freeze[i].thawed > j)
+				j = arena->freeze[i].thawed;
 
 		team_loop
-			if (freeze[i].thawed == j)
+			if (arena->freeze[i].thawed == j)
 			{
 				k++;
 				team = i;
@@ -790,13 +947,27 @@ void freezeIntermission(void)
 	}
 	if (k != 1)
 	{
-		gi.bprintf(PRINT_HIGH, "Stalemate!\n");
-		return;
+		arenaPrintf(arena, "Stalemate!\n");
+		G_JournalEvent(JE_END, NULL, NULL, none, 0, 0);
+		return none;
 	}
-	gi.bprintf(PRINT_HIGH, "%s team is the winner!\n", freeze_team[team]);
+	arenaPrintf(arena, "%s team is the winner!\n", freeze_team[team]);
+	G_JournalEvent(JE_END, NULL, NULL, team, arena->freeze[team].score, arena->freeze[team].thawed);
 	team_loop
-		freeze[i].win_time = level.time;
-	freeze[team].win_time = far_off;
+		arena->freeze[i].win_time = level.time;
+	arena->freeze[team].win_time = far_off;
+	return team;
+}
+
+void freezeIntermission(void)
+{
+	arenanode*	arena;
+
+	// read the next map's config while the scoreboard is up
+	G_PrefetchFile(G_ConfigName());
+
+	for (arena = arenas; arena < arenas + numarenas; arena++)
+		arenaWinner(arena);
 }
 
 char* makeGreen(char* s)
@@ -832,7 +1003,7 @@ static void playerHealth(edict_t* ent)
 	ent->client->weapon_sound = 0;
 }
 
-static void breakTeam(int team)
+static void breakTeam(arenanode* arena, int team)
 {
 	int	i;
 	edict_t*	ent;
@@ -844,28 +1015,31 @@ static void breakTeam(int team)
 		ent = g_edicts + 1 + i;
 		if (!ent->inuse)
 			continue;
+		if (arena_of(ent) != arena)
+			continue;
 		if (ent->client->frozen)
 		{
-			if (ent->client->resp.team != team && team_max_count >= 3)
+			if (ent->client->resp.team != team && arena->team_max_count >= 3)
 				continue;
 			ent->client->frozen_time = break_time;
 			break_time += 0.25;
 			continue;
 		}
-		if (ent->health > 0 && team_max_count < 3)
+		if (ent->health > 0 && arena->team_max_count < 3)
 		{
 			playerHealth(ent);
 			playerWeapon(ent);
 		}
 	}
-	freeze[team].break_time = break_time + 1;
+	arena->freeze[team].break_time = break_time + 1;
+	G_JournalEvent(JE_BREAK, NULL, NULL, team, 0, 0);
 	if (rand() &1)
-		gi.bprintf (PRINT_HIGH, "%s team was run circles around by their foe.\n", freeze_team[team]);
+		arenaPrintf(arena, "%s team was run circles around by their foe.\n", freeze_team[team]);
 	else
-		gi.bprintf (PRINT_HIGH, "%s team was less than a match for their foe.\n", freeze_team[team]);
+		arenaPrintf(arena, "%s team was less than a match for their foe.\n", freeze_team[team]);
 }
 
-static void updateTeam(int team)
+static void updateTeam(arenanode* arena, int team)
 {
 	int	i;
 	edict_t*	ent;
@@ -879,6 +1053,8 @@ static void updateTeam(int team)
 		ent = g_edicts + 1 + i;
 		if (!ent->inuse)
 			continue;
+		if (arena_of(ent) != arena)
+			continue;
 		if (ent->client->resp.spectator)
 			continue;
 		if (ent->client->resp.team != team)
@@ -888,38 +1064,38 @@ static void updateTeam(int team)
 		if (ent->health > 0)
 			alive++;
 	}
-	freeze[team].frozen = frozen;
-	freeze[team].alive = alive;
+	arena->freeze[team].frozen = frozen;
+	arena->freeze[team].alive = alive;
 
 	if (frozen && !alive)
 	{
 		team_loop
 		{
-			if (freeze[i].alive)
+			if (arena->freeze[i].alive)
 			{
 				play_sound++;
-				freeze[i].score++;
-				freeze[i].win_time = level.time + 5;
-				freeze[i].update = true;
+				arena->freeze[i].score++;
+				arena->freeze[i].win_time = level.time + 5;
+				arena->freeze[i].update = true;
 			}
 		}
-		breakTeam(team);
+		breakTeam(arena, team);
 
 		if (play_sound <= 1)
-			gi.positioned_sound(vec3_origin, world, CHAN_VOICE | CHAN_RELIABLE, gi.soundindex("world/xian1.wav"), 1, ATTN_NONE, 0);
+			arenaSound(arena, "world/xian1.wav");
 	}
 
-	Com_sprintf(small, sizeof(small), " %s%3d/%3d", freeze_team__[team], freeze[team].score, freeze[team].alive);
+	Com_sprintf(small, sizeof(small), " %s%3d/%3d", freeze_team__[team], arena->freeze[team].score, arena->freeze[team].alive);
 //	if (!(freeze[team].alive == 1 && freeze[team].frozen))
 //		makeGreen(small);
-	gi.configstring(CS_GENERAL + team, small);
+	gi.configstring(arena_cs(arena, team), small);
 }
 
-qboolean endCheck()
+static qboolean arenaCheck(arenanode* arena)
 {
 	int	i;
 
-	if (!(level.framenum &31))
+	if (!(level.framenum % BASEFRAMES(32)))
 	{
 		if (new_team_count->value)
 		{
@@ -927,29 +1103,30 @@ qboolean endCheck()
 			int	total[nteam];
 
 			_team_loop
-				total[i] = freeze[i].alive + freeze[i].frozen;
+				total[i] = arena->freeze[i].alive + arena->freeze[i].frozen;
 
 			if (total[yellow])
-				team_max_count = 4;
+				arena->team_max_count = 4;
 			else if (total[red] >= _new_team_count && total[blue] >= _new_team_count)
 			{
 				if (total[green] >= _new_team_count)
-					team_max_count = 4;
+					arena->team_max_count = 4;
 				else
-					team_max_count = 3;
+					arena->team_max_count = 3;
 			}
 			else if (total[green])
-				team_max_count = 3;
+				arena->team_max_count = 3;
 			else
-				team_max_count = 0;
+				arena->team_max_count = 0;
 		}
 		else
-			team_max_count = 0;
+			arena->team_max_count = 0;
 	}
 
-	if (use_ready->value && !(lame_hack &everyone_ready))
+	if (use_ready->value && !(arena->lame_hack &everyone_ready))
 	{
-		switch ((int)(ready_time / FRAMETIME) - level.framenum)
+		// tenths of a second left, counted once every BASETIME
+		switch (ISBASEFRAME ? (int)((arena->ready_time - level.time) * 10 + 0.5) : 0)
 		{
 		case 150:
 		case 100:
@@ -957,19 +1134,21 @@ qboolean endCheck()
 		case 40:
 		case 30:
 		case 20:
-			gi.bprintf(PRINT_HIGH, "Begin in %d seconds!\n", (int)(((ready_time / FRAMETIME) - level.framenum) * FRAMETIME));
+			arenaPrintf(arena, "Begin in %d seconds!\n", (int)(arena->ready_time - level.time + 0.5));
 		}
-		if (level.time > ready_time)
+		if (level.time > arena->ready_time)
 		{
 			edict_t*	ent;
 
-			lame_hack |= everyone_ready;
-			gi.bprintf(PRINT_HIGH, "Begin!\n");
+			arena->lame_hack |= everyone_ready;
+			arenaPrintf(arena, "Begin!\n");
 			game_loop
 			{
 				ent = g_edicts + 1 + i;
 				if (!ent->inuse)
 					continue;
+				if (arena_of(ent) != arena)
+					continue;
 				if (ent->client->resp.spectator)
 					continue;
 				if (ent->health > 0)
@@ -981,14 +1160,14 @@ qboolean endCheck()
 		}
 	}
 	else
-		lame_hack |= everyone_ready;
+		arena->lame_hack |= everyone_ready;
 
 	team_loop
-		if (freeze[i].update && level.time > freeze[i].last_update)
+		if (arena->freeze[i].update && level.time > arena->freeze[i].last_update)
 		{
-			updateTeam(i);
-			freeze[i].update = false;
-			freeze[i].last_update = level.time + 3;
+			updateTeam(arena, i);
+			arena->freeze[i].update = false;
+			arena->freeze[i].last_update = level.time + 3;
 		}
 
 	if (point_limit->value)
@@ -996,18 +1175,234 @@ qboolean endCheck()
 		int	_point_limit;
 
 		_point_limit = point_limit->value;
-		if (team_max_count >= 3)
+		if (arena->team_max_count >= 3)
 			_point_limit *= 3;
 		team_loop
-			if (freeze[i].score >= _point_limit)
+			if (arena->freeze[i].score >= _point_limit)
 				return true;
 	}
+	return false;
+}
+
+static qboolean arenaBreak(arenanode* arena)
+{
+	int	i;
+
+	team_loop
+		if (arena->freeze[i].break_time > level.time)
+			return true;
+	return false;
+}
+
+// a match that is over in one arena of several starts again there
+static void arenaRestart(arenanode* arena)
+{
+	int	i, team;
+	edict_t*	ent;
+	float	break_time;
+
+	team = arenaWinner(arena);
+	team_loop
+	{
+		arena->freeze[i].score = 0;
+		arena->freeze[i].thawed = 0;
+		arena->freeze[i].win_time = 0;
+		arena->freeze[i].ready = false;
+		arena->freeze[i].update = true;
+	}
+	if (team != none)
+		arena->freeze[team].win_time = level.time + 5;
+	arena->lame_hack &= ~everyone_ready;
+	arena->ready_time = far_off;
+
+	break_time = level.time;
+	game_loop
+	{
+		ent = g_edicts + 1 + i;
+		if (!ent->inuse)
+			continue;
+		if (arena_of(ent) != arena)
+			continue;
+		if (ent->client->frozen)
+		{
+			ent->client->frozen_time = break_time;
+			break_time += 0.25;
+		}
+		else if (ent->health > 0 && !ent->client->resp.spectator)
+		{
+			playerHealth(ent);
+			playerWeapon(ent);
+		}
+	}
+}
+
+// true when every arena is between rounds
+qboolean breakCheck()
+{
+	arenanode*	arena;
+
+	for (arena = arenas; arena < arenas + numarenas; arena++)
+		if (!arenaBreak(arena))
+			return false;
+	return true;
+}
+
+qboolean endCheck()
+{
+	arenanode*	arena;
+
+	for (arena = arenas; arena < arenas + numarenas; arena++)
+	{
+		if (arenaBreak(arena))
+			continue;
+		if (!arenaCheck(arena))
+			continue;
+		if (numarenas == 1)
+			return true;
+		arenaRestart(arena);
+	}
 	if (lame_hack &end_vote)
 		return true;
 
 	return false;
 }
 
+/*
+A flashlight keeps the last beam it traced: move_origin and move_angles
+are where from and which way, pos1 and speed where and how far it ended,
+and enemy what it ended on.  While the owner holds still and nothing comes
+into the beam, the endpoint is only carried along with the view.
+
+Beams that do need tracing share flashlight_traces a frame.  One that
+misses out joins flash_queue (count 1), and each frame the oldest in the
+queue are promised the traces first (count 2).
+*/
+static qboolean beamCrosses(vec3_t start, vec3_t end, edict_t* other)
+{
+	float	enter, leave, d, t0, t1;
+	int	i;
+
+	enter = 0;
+	leave = 1;
+	for (i = 0; i < 3; i++)
+	{
+		d = end[i] - start[i];
+		if (!d)
+		{
+			if (start[i] < other->absmin[i] - flash_move || start[i] > other->absmax[i] + flash_move)
+				return false;
+			continue;
+		}
+		t0 = (other->absmin[i] - flash_move - start[i]) / d;
+		t1 = (other->absmax[i] + flash_move - start[i]) / d;
+		if (t0 > t1)
+		{
+			d = t0;
+			t0 = t1;
+			t1 = d;
+		}
+		if (t0 > enter)
+			enter = t0;
+		if (t1 < leave)
+			leave = t1;
+		if (enter > leave)
+			return false;
+	}
+	return true;
+}
+
+static qboolean flashlightStale(edict_t* ent, vec3_t start, vec3_t forward)
+{
+	edict_t*	touch[MAX_EDICTS];
+	vec3_t	v, mins, maxs;
+	int	i, n;
+
+	// never traced, or it stopped on something that can move
+	if (ent->enemy != g_edicts)
+		return true;
+
+	VectorSubtract(start, ent->move_origin, v);
+	if (VectorLength(v) > flash_move)
+		return true;
+	// the new ray at the old range has to end where the old beam did,
+	// which a turn right round doesn't
+	VectorMA(start, ent->speed, forward, v);
+	VectorSubtract(v, ent->pos1, v);
+	if (VectorLength(v) > flash_move)
+		return true;
+
+	for (i = 0; i < 3; i++)
+	{
+		mins[i] = (ent->move_origin[i] < ent->pos1[i] ? ent->move_origin[i] : ent->pos1[i]) - flash_move;
+		maxs[i] = (ent->move_origin[i] > ent->pos1[i] ? ent->move_origin[i] : ent->pos1[i]) + flash_move;
+	}
+	n = gi.BoxEdicts(mins, maxs, touch, MAX_EDICTS, AREA_SOLID);
+	for (i = 0; i < n; i++)
+	{
+		if (touch[i] == ent->owner || touch[i]->owner == ent->owner)
+			continue;
+		if (beamCrosses(ent->move_origin, ent->pos1, touch[i]))
+			return true;
+	}
+	return false;
+}
+
+void flashlightThink(edict_t* ent);
+
+static void flashlightFrame()
+{
+	edict_t*	light;
+	int	i, n, cap;
+
+	flash_frame = level.framenum;
+	flash_used = 0;
+	flash_granted = 0;
+	cap = flashlight_traces->value;
+
+	// drop the ones that have traced or gone, 3 marks a light already kept
+	for (i = n = 0; i < flash_queued; i++)
+	{
+		light = g_edicts + flash_queue[i];
+		if (light->count != 1 || !light->inuse || light->think != flashlightThink)
+			continue;
+		if (flash_granted < cap)
+		{
+			light->count = 2;
+			flash_granted++;
+		}
+		else
+			light->count = 3;
+		flash_queue[n++] = flash_queue[i];
+	}
+	flash_queued = n;
+	for (i = 0; i < flash_queued; i++)
+		if (g_edicts[flash_queue[i]].count == 3)
+			g_edicts[flash_queue[i]].count = 1;
+}
+
+static qboolean flashlightBudget(edict_t* ent)
+{
+	int	cap;
+
+	cap = flashlight_traces->value;
+
+	// promised one, or there is one to spare, and a new beam always gets one
+	if (ent->count == 2)
+		flash_granted--;
+	else if (cap > 0 && ent->enemy && flash_used + flash_granted >= cap)
+	{
+		if (!ent->count && flash_queued < MAX_EDICTS)
+		{
+			ent->count = 1;
+			flash_queue[flash_queued++] = ent - g_edicts;
+		}
+		return false;
+	}
+	ent->count = 0;
+	flash_used++;
+	return true;
+}
+
 void flashlightThink(edict_t* ent)
 {
 	vec3_t	forward, right, offset;
@@ -1022,9 +1417,28 @@ void flashlightThink(edict_t* ent)
 	AngleVectors(ent->owner->client->v_angle, forward, right, NULL);
 	VectorSet(offset, 0, random() < 0.2 ? crandom() : 0, ent->owner->viewheight);
 	G_ProjectSource(ent->owner->s.origin, offset, forward, right, start);
-	VectorMA(start, 8192, forward, end);
-	trace = gi.trace(start, NULL, NULL, end, ent->owner, CONTENTS_SOLID | CONTENTS_MONSTER | CONTENTS_DEADMONSTER);
-	VectorCopy(trace.endpos, ent->s.origin);
+	if (flash_frame != level.framenum)
+		flashlightFrame();
+	if (!flashlightStale(ent, start, forward))
+	{
+		if (ent->count == 2)
+			flash_granted--;
+		ent->count = 0;
+	}
+	else if (flashlightBudget(ent))
+	{
+		VectorMA(start, flash_range, forward, end);
+		trace = gi.trace(start, NULL, NULL, end, ent->owner, CONTENTS_SOLID | CONTENTS_MONSTER | CONTENTS_DEADMONSTER);
+		VectorCopy(start, ent->move_origin);
+		VectorCopy(forward, ent->move_angles);
+		VectorCopy(trace.endpos, ent->pos1);
+		ent->speed = trace.fraction * flash_range;
+		ent->enemy = trace.ent;
+	}
+	if (VectorCompare(start, ent->move_origin) && VectorCompare(forward, ent->move_angles))
+		VectorCopy(ent->pos1, ent->s.origin);
+	else
+		VectorMA(start, ent->speed, forward, ent->s.origin);
 	gi.linkentity(ent);
 	ent->nextthink = level.time + FRAMETIME;
 }
@@ -1124,6 +1538,17 @@ void playerShell(edict_t* ent, int team)
 		ent->s.renderfx |= RF_SHELL_RED | RF_SHELL_GREEN;
 }
 
+/*
+Whether a thawing player's shell flashes this time round is decided here,
+on the game thread before the views go to the workers, as it asks the
+engine who can see them.  freezeEffects only reads the answer.
+*/
+void freezeShell(edict_t* ent)
+{
+	if (ent->client->frozen && ent->client->resp.thawer && !(level.framenum %BASEFRAMES(16)))
+		ent->client->steady_shell = !G_EffectEntity(ent->s.origin, FX_FLASH);
+}
+
 void freezeEffects(edict_t* ent)
 {
 	if (level.intermissiontime)
@@ -1132,7 +1557,7 @@ void freezeEffects(edict_t* ent)
 		ent->s.renderfx = RF_MINLIGHT;
 	if (!ent->client->frozen)
 		return;
-	if (!ent->client->resp.thawer || level.framenum &8)
+	if (!ent->client->resp.thawer || BASEFRAME &8 || ent->client->steady_shell)
 		playerShell(ent, ent->client->resp.team);
 }
 
@@ -1164,72 +1589,144 @@ void freezeSkin(edict_t* ent, char* s)
 enum pmenu_enum {
 	align_left, align_center, align_right };
 
-void pmenu_update(edict_t* ent)
+static qboolean pmenuRow(strbuf_t* sb, pmenunode* p, int i, qboolean cursor)
 {
-	hndnode*	hnd;
-	char	string[1400];
-	int	i;
-	pmenunode*	p;
 	char*	t;
 	qboolean	alt = false;
 	int	x;
 
-	if (!ent->client->menu)
-		return;
-	hnd = ent->client->menu;
-	strcpy(string, "xv 32 yv 32 picn inventory ");
-	for (i = 0, p = hnd->entries; i < hnd->num; i++, p++)
+	t = p->text;
+	if (*t == '*')
 	{
+		alt = true;
+		t++;
+	}
+	if (p->align == align_center)
+		x = (20 - (int)(strlen(t) / 2)) * 8;
+	else if (p->align == align_right)
+		x = (33 - (int)strlen(t)) * 8;
+	else
+		x = 56;
+	if (cursor)
+		return SB_Printf(sb, "xv %d yv %d string2 \">%s<\" ", x - 8, 32 + i * 8, t);
+	else if (alt)
+		return SB_Printf(sb, "xv %d yv %d string2 \"%s\" ", x, 32 + i * 8, t);
+	else
+		return SB_Printf(sb, "xv %d yv %d string \"%s\" ", x, 32 + i * 8, t);
+}
+
+/*
+Called whenever the text of a menu changes.  The layout without a cursor
+is built first, and each row the cursor can be on is then patched into a
+copy of it.
+*/
+void pmenuCompile(pmenulayout* menu)
+{
+	char	base[MAX_MENU_LAYOUT];
+	char	row[MAX_MENU_LAYOUT];
+	strbuf_t	sb, rsb;
+	int	start[MAX_MENU_ROWS], end[MAX_MENU_ROWS];
+	int	i, len, n, count;
+	pmenunode*	p;
+	char*	s;
+
+	if (menu->strings)
+		free(menu->strings);
+	menu->strings = NULL;
+	memset(menu->layout, 0, sizeof(menu->layout));
+	if (menu->num > MAX_MENU_ROWS)
+		menu->num = MAX_MENU_ROWS;
+
+	SB_Init(&sb, base, sizeof(base));
+	SB_Append(&sb, "xv 32 yv 32 picn inventory ");
+	count = 1;
+	for (i = 0, p = menu->entries; i < menu->num; i++, p++)
+	{
+		start[i] = end[i] = sb.len;
+		if (p->selectfunc)
+			count++;
 		if (!p->text)
 			continue;
-		t = p->text;
-		if (*t == '*')
+		if (!pmenuRow(&sb, p, i, false))
 		{
-			alt = true;
-			t++;
+			SB_Truncate(&sb, start[i]);
+			continue;
 		}
-		if (p->align == align_center)
-			x = (20 - (int)(strlen(t) / 2)) * 8;
-		else if (p->align == align_right)
-			x = (33 - strlen(t)) * 8;
-		else
-			x = 56;
-		sprintf(string + strlen(string), "xv %d yv %d ", x - (hnd->cur == i ? 8 : 0), 32 + i * 8);
-		if (hnd->cur == i)
-			sprintf(string + strlen(string), "string2 \">%s<\" ", t);
-		else if (alt)
-			sprintf(string + strlen(string), "string2 \"%s\" ", t);
-		else
-			sprintf(string + strlen(string), "string \"%s\" ", t);
-		alt = false;
+		end[i] = sb.len;
 	}
+	len = sb.len;
+
+	menu->strings = malloc(count * MAX_MENU_LAYOUT);
+	if (!menu->strings)
+		gi.error("pmenuCompile: out of memory");
+	s = menu->strings;
+	memcpy(s, base, len + 1);
+	menu->layout[MAX_MENU_ROWS] = s;
+	for (i = 0, p = menu->entries; i < menu->num; i++, p++)
+	{
+		if (!p->selectfunc)
+			continue;
+		s += MAX_MENU_LAYOUT;
+		menu->layout[i] = s;
+		if (!p->text)
+		{
+			memcpy(s, base, len + 1);
+			continue;
+		}
+		SB_Init(&rsb, row, sizeof(row));
+		pmenuRow(&rsb, p, i, true);
+		n = rsb.len;
+		if (rsb.overflowed || start[i] + n + len - end[i] >= MAX_MENU_LAYOUT)
+		{
+			memcpy(s, base, len + 1);
+			continue;
+		}
+		memcpy(s, base, start[i]);
+		memcpy(s + start[i], row, n);
+		memcpy(s + start[i] + n, base + end[i], len - end[i] + 1);
+	}
+}
+
+void pmenu_update(edict_t* ent)
+{
+	hndnode*	hnd;
+	char*	layout;
+
+	hnd = &ent->client->menu;
+	if (!hnd->entries)
+		return;
+	layout = hnd->cur >= 0 ? hnd->layout->layout[hnd->cur] : NULL;
+	if (!layout)
+		layout = hnd->layout->layout[MAX_MENU_ROWS];
 	gi.WriteByte(svc_layout);
-	gi.WriteString(string);
+	gi.WriteString(layout);
 }
 
 void pmenu_close(edict_t* ent)
 {
-	if (!ent->client->menu)
+	if (!ent->client->menu.entries)
 		return;
-	free(ent->client->menu);
-	ent->client->menu = NULL;
+	ent->client->menu.entries = NULL;
 	ent->client->showscores = false;
 }
 
-void pmenu_open(edict_t* ent, pmenunode* entries, int cur, int num)
+void pmenu_open(edict_t* ent, pmenulayout* menu, int cur)
 {
 	hndnode*	hnd;
 	int	i;
 	pmenunode*	p;
 
-	if (ent->client->menu)
+	if (ent->client->menu.entries)
 		pmenu_close(ent);
-	hnd = malloc(sizeof(*hnd));
-	hnd->entries = entries;
-	hnd->num = num;
-	if (cur < 0 || !entries[cur].selectfunc)
+	if (!menu->strings)
+		pmenuCompile(menu);
+	hnd = &ent->client->menu;
+	hnd->entries = menu->entries;
+	hnd->num = menu->num;
+	hnd->layout = menu;
+	if (cur < 0 || !hnd->entries[cur].selectfunc)
 	{
-		for (i = 0, p = entries; i < num; i++, p++)
+		for (i = 0, p = hnd->entries; i < hnd->num; i++, p++)
 		{
 			if (p->selectfunc)
 				break;
@@ -1237,12 +1734,11 @@ void pmenu_open(edict_t* ent, pmenunode* entries, int cur, int num)
 	}
 	else
 		i = cur;
-	if (i >= num)
+	if (i >= hnd->num)
 		hnd->cur = -1;
 	else
 		hnd->cur = i;
 	ent->client->showscores = true;
-	ent->client->menu = hnd;
 	pmenu_update(ent);
 	gi.unicast(ent, true);
 }
@@ -1253,9 +1749,9 @@ void pmenu_next(edict_t* ent)
 	int	i;
 	pmenunode*	p;
 
-	if (!ent->client->menu)
+	hnd = &ent->client->menu;
+	if (!hnd->entries)
 		return;
-	hnd = ent->client->menu;
 	if (hnd->cur < 0)
 		return;
 	i = hnd->cur;
@@ -1279,9 +1775,9 @@ void pmenu_prev(edict_t* ent)
 	int	i;
 	pmenunode*	p;
 
-	if (!ent->client->menu)
+	hnd = &ent->client->menu;
+	if (!hnd->entries)
 		return;
-	hnd = ent->client->menu;
 	if (hnd->cur < 0)
 		return;
 	i = hnd->cur;
@@ -1308,9 +1804,9 @@ void pmenu_select(edict_t* ent)
 	hndnode*	hnd;
 	pmenunode*	p;
 
-	if (!ent->client->menu)
+	hnd = &ent->client->menu;
+	if (!hnd->entries)
 		return;
-	hnd = ent->client->menu;
 	if (hnd->cur < 0)
 		return;
 	p = hnd->entries + hnd->cur;
@@ -1383,10 +1879,12 @@ pmenunode	credits_menu[] = {
 	{NULL, 0, NULL, NULL}
 };
 
+static pmenulayout	credits_layout = {credits_menu, sizeof(credits_menu) / sizeof(pmenunode)};
+
 static void menu_credits(edict_t* ent, pmenunode* p)
 {
 	pmenu_close(ent);
-	pmenu_open(ent, credits_menu, -1, sizeof(credits_menu) / sizeof(pmenunode));
+	pmenu_open(ent, &credits_layout, -1);
 }
 
 pmenunode	title_menu[] = {
@@ -1416,6 +1914,48 @@ pmenunode	title_menu[] = {
 	{NULL, 0, NULL, NULL}
 };
 
+// title_menu with the Green and Yellow rows set for 2, 3 and 4 teams, so
+// players in arenas with different team counts can have it open at once
+static pmenunode	title_menus[3][sizeof(title_menu) / sizeof(pmenunode)];
+static pmenulayout	title_layouts[3];
+
+static pmenulayout* titleLayout(arenanode* arena)
+{
+	pmenulayout*	layout;
+	pmenunode*	p;
+	int	n;
+
+	if (arena->team_max_count >= 4)
+		n = 2;
+	else if (arena->team_max_count >= 3)
+		n = 1;
+	else
+		n = 0;
+	layout = &title_layouts[n];
+	if (layout->entries)
+		return layout;
+
+	p = title_menus[n];
+	memcpy(p, title_menu, sizeof(title_menu));
+	if (n >= 1)
+	{
+		p[14].text = "Join Green Team";
+		p[14].selectfunc = menu_green;
+	}
+	else
+		p[14].text = "*Join Green Team";
+	if (n >= 2)
+	{
+		p[15].text = "Join Yellow Team";
+		p[15].selectfunc = menu_yellow;
+	}
+	else
+		p[15].text = "*Join Yellow Team";
+	layout->entries = p;
+	layout->num = sizeof(title_menu) / sizeof(pmenunode);
+	return layout;
+}
+
 pmenunode	motd_menu[] = {
 	{NULL, align_center, NULL, NULL}, 
 	{NULL, align_center, NULL, NULL}, 
@@ -1441,12 +1981,32 @@ pmenunode	motd_menu[] = {
 	{NULL, align_center, NULL, NULL}
 };
 
+static pmenulayout	motd_layout = {motd_menu, sizeof(motd_menu) / sizeof(pmenunode)};
+
+void pmenuFree()
+{
+	int	i;
+
+	if (credits_layout.strings)
+		free(credits_layout.strings);
+	for (i = 0; i < 3; i++)
+	{
+		if (title_layouts[i].strings)
+			free(title_layouts[i].strings);
+		title_layouts[i].strings = NULL;
+	}
+	if (motd_layout.strings)
+		free(motd_layout.strings);
+	credits_layout.strings = motd_layout.strings = NULL;
+}
+
 void do_main(edict_t* ent)
 {
 	int	total[nteam];
 	int	i;
 	edict_t*	other;
 	int	best_total = 128, best_team = -1;
+	arenanode*	arena = arena_of(ent);
 
 	_team_loop
 		total[i] = 0;
@@ -1455,6 +2015,8 @@ void do_main(edict_t* ent)
 		other = g_edicts + 1 + i;
 		if (!other->inuse)
 			continue;
+		if (arena_of(other) != arena)
+			continue;
 		if (other->client->resp.spectator)
 			continue;
 		total[other->client->resp.team]++;
@@ -1462,9 +2024,9 @@ void do_main(edict_t* ent)
 
 	team_loop
 	{
-		if (i == green && team_max_count < 3)
+		if (i == green && arena->team_max_count < 3)
 			continue;
-		if (i == yellow && team_max_count < 4)
+		if (i == yellow && arena->team_max_count < 4)
 			continue;
 		if (total[i] <= best_total)
 		{
@@ -1475,28 +2037,7 @@ void do_main(edict_t* ent)
 		}
 	}
 
-	if (team_max_count >= 3)
-	{
-		title_menu[14].text = "Join Green Team";
-		title_menu[14].selectfunc = menu_green;
-	}
-	else
-	{
-		title_menu[14].text = "*Join Green Team";
-		title_menu[14].selectfunc = NULL;
-	}
-	if (team_max_count >= 4)
-	{
-		title_menu[15].text = "Join Yellow Team";
-		title_menu[15].selectfunc = menu_yellow;
-	}
-	else
-	{
-		title_menu[15].text = "*Join Yellow Team";
-		title_menu[15].selectfunc = NULL;
-	}
-
-	pmenu_open(ent, title_menu, best_team + 12, sizeof(title_menu) / sizeof(pmenunode));
+	pmenu_open(ent, titleLayout(arena), best_team + 12);
 }
 
 static void sayArmor(edict_t* ent, char* buf)
@@ -1578,13 +2119,14 @@ static qboolean loc_cansee(edict_t* targ, edict_t* inflictor)
 
 static void saySight(edict_t* who, char* buf)
 {
-	char	s[1024], s2[1024];
-	int	i;
+	char	s[1024];
+	strbuf_t	sb;
+	char*	last = "";
+	int	i, mark;
 	edict_t*	targ;
 	int	n = 0;
 
-	*s = 0;
-	*s2 = 0;
+	SB_Init(&sb, s, sizeof(s));
 	game_loop
 	{
 		targ = g_edicts + 1 + i;
@@ -1592,27 +2134,24 @@ static void saySight(edict_t* who, char* buf)
 			continue;
 		if (!loc_cansee(targ, who))
 			continue;
-		if (*s2)
+		if (*last)
 		{
-			if (strlen(s) + strlen(s2) + 3 < sizeof(s))
-			{
-				if (n)
-					strcat(s, ", ");
-				strcat(s, s2);
-				*s2 = 0;
-			}
+			mark = sb.len;
+			if (n)
+				SB_Append(&sb, ", ");
+			if (!SB_Append(&sb, last))
+				SB_Truncate(&sb, mark);
 			n++;
 		}
-		strcpy(s2, targ->client->pers.netname);
+		last = targ->client->pers.netname;
 	}
-	if (*s2 && !level.intermissiontime)
+	if (*last && !level.intermissiontime)
 	{
-		if (strlen(s) + strlen(s2) + 6 < sizeof(s))
-		{
-			if (n)
-				strcat(s, " and ");
-			strcat(s, s2);
-		}
+		mark = sb.len;
+		if (n)
+			SB_Append(&sb, " and ");
+		if (!SB_Append(&sb, last))
+			SB_Truncate(&sb, mark);
 		strcpy(buf, s);
 	}
 	else
@@ -1814,6 +2353,8 @@ void sayTeam(edict_t* who)
 		cl_ent = g_edicts + 1 + i;
 		if (!cl_ent->inuse)
 			continue;
+		if (cl_ent->client->resp.arena != who->client->resp.arena)
+			continue;
 		if (cl_ent->client->resp.spectator)
 		{
 			if (!who->client->resp.spectator)
@@ -1831,59 +2372,45 @@ void sayTeam(edict_t* who)
 
 static void loadMessage()
 {
-	cvar_t*	game;
-	char	name[MAX_OSPATH];
-	FILE*	f;
-	char	st[128];
-	int	index = 0;
+	int	i;
 
 	lame_hack &= ~is_motd;
-	game = gi.cvar("game", "", 0);
-	if (!*game->string)
-		sprintf(name, "baseq2/freeze.ini");
-	else
-		sprintf(name, "%s/freeze.ini", game->string);
-	f = fopen(name, "r");
-	if (!f)
-		return;
-	while (fgets(st, sizeof(st), f))
-	{
-		if (strstr(st, "[motd]"))
-			break;
-	}
-	if (feof(f))
+	for (i = 0; i < MAX_MOTD_LINES; i++)
 	{
-		fclose(f);
-		return;
-	}
-	while (fgets(st, sizeof(st), f))
-	{
-		if (strstr(st, "//"))
-			continue;
-		if (strstr(st, "###"))
-			break;
-		st[strlen(st) - 1] = 0;
-		if (strlen(st))
-		{
-			motd_menu[index].text = G_CopyString(st);
+		motd_menu[i].text = i < config.nummotd ? config.motd[i] : NULL;
+		if (motd_menu[i].text)
 			lame_hack |= is_motd;
-		}
-		index++;
 	}
-	fclose(f);
+	pmenuCompile(&motd_layout);
 }
 
 void pmenuBegin(edict_t* ent)
 {
 	if (ent->client->resp.team == none && lame_hack &is_motd)
-		pmenu_open(ent, motd_menu, -1, sizeof(motd_menu) / sizeof (pmenunode));
+		pmenu_open(ent, &motd_layout, -1);
 	else
 		do_main(ent);
 }
 
-void playerStat(edict_t* ent)
+void teamStats(short* stats, int n)
 {
 	int	i;
+	arenanode*	arena = &arenas[n];
+
+	team_loop
+	{
+		if (((i == green && arena->team_max_count < 3) || (i == yellow && arena->team_max_count < 4)) || 
+			(arena->freeze[i].win_time > level.time && !(BASEFRAME &8)))
+			stats[stat_red + i] = 0;
+		else
+			stats[stat_red + i] = arena_cs(arena, i);
+		stats[stat_red_arrow + i] = 0;
+	}
+}
+
+void playerStat(edict_t* ent, short* stats)
+{
+	int	team;
 
 	if (ent->client->viewed && ent->client->viewed->inuse)
 	{
@@ -1894,22 +2421,10 @@ void playerStat(edict_t* ent)
 	else
 		ent->client->ps.stats[stat_identify] = 0;
 
-	team_loop
-	{
-		if (((i == green && team_max_count < 3) || (i == yellow && team_max_count < 4)) || 
-			(freeze[i].win_time > level.time && !(level.framenum &8)))
-		{
-			ent->client->ps.stats[stat_red + i] = 0;
-			ent->client->ps.stats[stat_red_arrow + i] = 0;
-			continue;
-		}
-
-		ent->client->ps.stats[stat_red + i] = CS_GENERAL + i;
-		if (ent->client->resp.team == i && !ent->client->resp.spectator)
-			ent->client->ps.stats[stat_red_arrow + i] = CS_GENERAL + 5;
-		else
-			ent->client->ps.stats[stat_red_arrow + i] = 0;
-	}
+	memcpy(ent->client->ps.stats + stat_red, stats + stat_red, (stat_red_arrow + none - stat_red) * sizeof(short));
+	team = ent->client->resp.team;
+	if (team != none && !ent->client->resp.spectator && stats[stat_red + team])
+		ent->client->ps.stats[stat_red_arrow + team] = CS_GENERAL + 5;
 }
 
 static void p_projectsourcereverse(gclient_t* client, vec3_t point, vec3_t distance, vec3_t forward, vec3_t right, vec3_t result)
@@ -1973,10 +2488,12 @@ void hookbehavior(edict_t* ent)
 	vec3_t	chainvec, velpart;
 	float	chainlen;
 	float	force;
-	int	_hook_rpf = hook_rpf->value;
+	float	_hook_rpf = hook_rpf->value;
 
 	if (!_hook_rpf)
 		_hook_rpf = 80;
+	// hook_rpf is per BASETIME
+	_hook_rpf /= framediv;
 
 	targ = ent->owner;
 	if (!targ->inuse || !(targ->client->hookstate &hook_on) || ent->enemy->solid == SOLID_NOT || 
@@ -2120,14 +2637,7 @@ void hooktouch(edict_t* ent, edict_t* other, cplane_t* plane, csurface_t* surf)
 	{
 		if (!ent->owner->client->resp.old_hook)
 			VectorClear(ent->owner->velocity);
-		gi.WriteByte(svc_temp_entity);
-		gi.WriteByte(TE_SHOTGUN);
-		gi.WritePosition(ent->s.origin);
-		if (!plane)
-			gi.WriteDir(vec3_origin);
-		else
-			gi.WriteDir(plane->normal);
-		gi.multicast(ent->s.origin, MULTICAST_PVS);
+		G_EffectTemp(TE_SHOTGUN, ent->s.origin, plane ? plane->normal : vec3_origin);
 		gi.sound(ent, CHAN_VOICE, gi.soundindex(_touchsolid), 1, ATTN_IDLE, 0);
 	}
 	else
@@ -2169,6 +2679,7 @@ static void firehook(edict_t* ent)
 	damage = 10;
 	if (ent->client->quad_framenum > level.framenum)
 		damage *= 4;
+	G_JournalEvent(JE_HOOK, ent, NULL, ent->client->resp.team, 0, 0);
 
 	AngleVectors(ent->client->v_angle, forward, right, NULL);
 	VectorSet(offset, 8, 8, ent->viewheight - 8);
@@ -2254,97 +2765,136 @@ void cmdHook(edict_t* ent)
 	}
 }
 
-static void addmap(char* s)
+/*
+Votes are tallied as they come in.  Maps with the same number of votes are
+linked together in vote_bucket, so the leader is always the head of
+vote_bucket[vote_max].  The map list shown by vote is built once per config.
+*/
+#define	vote_page_size	900
+
+static int	vote_bucket[MAX_CLIENTS + 1];
+static int	vote_max;
+static int	vote_count;
+static int	vote_frame;
+static int	vote_players;
+static iobuf_t	vote_text;
+static int*	vote_page;
+static int	vote_pages;
+
+static void voteUnlink(int map)
 {
-	char*	t;
-	int	i, j;
+	mapentry_t*	m = &config.maps[map];
 
-	map_loop
-	{
-		if (maplist[i].name)
-			continue;
+	if (m->voteprev != -1)
+		config.maps[m->voteprev].votenext = m->votenext;
+	else
+		vote_bucket[m->votes] = m->votenext;
+	if (m->votenext != -1)
+		config.maps[m->votenext].voteprev = m->voteprev;
+}
 
-		t = strtok(s, ",");
-		j = 0;
-		while (t != NULL)
-		{
-			if (j == 0)
-				maplist[i].name = G_CopyString(t);
-			else if (j == 1)
-				maplist[i].gravity = G_CopyString(t);
-			else if (j == 2)
-				maplist[i].light = atoi(t);
-			else if (j == 3)
-				maplist[i].hook = (atoi(t) == 0 ? false : true);
-			else
-				break;
-			j++;
-			t = strtok(NULL, ",");
-		}
-		break;
-	}
+static void voteLink(int map)
+{
+	mapentry_t*	m = &config.maps[map];
+
+	m->voteprev = -1;
+	m->votenext = vote_bucket[m->votes];
+	if (m->votenext != -1)
+		config.maps[m->votenext].voteprev = map;
+	vote_bucket[m->votes] = map;
 }
 
-static void loadMap()
+void freezeVote(gclient_t* client, int vote)
 {
-	cvar_t*	game;
-	char	name[MAX_OSPATH];
-	FILE*	f;
-	char	st[128];
+	int	old = client->resp.vote;
+	mapentry_t*	m;
 
-	memset(maplist, 0, sizeof(maplist));
-	game = gi.cvar("game", "", 0);
-	if (!*game->string)
-		sprintf(name, "baseq2/freeze.ini");
-	else
-		sprintf(name, "%s/freeze.ini", game->string);
-	f = fopen(name, "r");
-	if (!f)
+	if (old == vote)
 		return;
-	while (fgets(st, sizeof(st), f))
+	client->resp.vote = vote;
+	if (old >= 0 && old < config.nummaps)
 	{
-		if (strstr(st, "[maplist]"))
-			break;
+		m = &config.maps[old];
+		voteUnlink(old);
+		m->votes--;
+		if (m->votes)
+			voteLink(old);
+		while (vote_max && vote_bucket[vote_max] == -1)
+			vote_max--;
+		vote_count--;
 	}
-	if (feof(f))
+	if (vote >= 0 && vote < config.nummaps)
 	{
-		fclose(f);
-		return;
+		m = &config.maps[vote];
+		if (m->votes)
+			voteUnlink(vote);
+		m->votes++;
+		voteLink(vote);
+		if (m->votes > vote_max)
+			vote_max = m->votes;
+		vote_count++;
 	}
-	while (fgets(st, sizeof(st), f))
+}
+
+static void voteReset()
+{
+	int	i;
+
+	for (i = 0; i <= MAX_CLIENTS; i++)
+		vote_bucket[i] = -1;
+	map_loop
+		config.maps[i].votes = 0;
+	for (i = 0; i < game.maxclients; i++)
+		game.clients[i].resp.vote = -1;
+	vote_max = vote_count = 0;
+	vote_frame = -1;
+}
+
+static void loadVote()
+{
+	int	i, len;
+
+	G_FreeIOBuf(&vote_text);
+	if (vote_page)
+		free(vote_page);
+	vote_page = malloc((config.nummaps + 1) * sizeof(int));
+	if (!vote_page)
+		gi.error("loadVote: out of memory");
+	vote_pages = 0;
+
+	map_loop
 	{
-		if (strstr(st, "//"))
-			continue;
-		if (strstr(st, "###"))
-			break;
-		st[strlen(st) - 1] = 0;
-		if (strlen(st))
-			addmap(st);
+		len = strlen(config.maps[i].name) + 1;
+		if (!vote_pages || vote_text.cursize - vote_page[vote_pages - 1] + len > vote_page_size)
+		{
+			if (vote_pages)
+				G_IOBufWrite(&vote_text, "", 1);
+			vote_page[vote_pages++] = vote_text.cursize;
+		}
+		G_IOBufWrite(&vote_text, config.maps[i].name, len - 1);
+		G_IOBufWrite(&vote_text, "\n", 1);
 	}
-	fclose(f);
+	G_IOBufWrite(&vote_text, "", 1);
 }
 
 static int mapCount()
 {
 	int	i;
-	edict_t*	other;
-	int	vote_count, player_count;
 	int	needed;
 
-	vote_count = player_count = 0;
-	game_loop
+	// players only change between frames, votes can come in faster
+	if (vote_frame != level.framenum)
 	{
-		other = g_edicts + 1 + i;
-		if (!other->inuse)
-			continue;
-		if (other->client->resp.vote != -1)
-			vote_count++;
-		player_count++;
+		vote_frame = level.framenum;
+		vote_players = 0;
+		game_loop
+			if (g_edicts[i + 1].inuse)
+				vote_players++;
 	}
 	if (vote_percent->value)
-		needed = (int)((vote_percent->value / 100) * player_count) - vote_count;
+		needed = (int)((vote_percent->value / 100) * vote_players) - vote_count;
 	else
-		needed = (int)(0.50 * player_count) - vote_count;
+		needed = (int)(0.50 * vote_players) - vote_count;
 	return (needed > 0 ? needed : 0);
 }
 
@@ -2352,134 +2902,162 @@ void cmdVote(edict_t* ent)
 {
 	int	i;
 	char*	s;
+	mapentry_t*	map;
 
-	if (!maplist[0].name)
+	if (!config.nummaps)
 		return;
 	s = gi.argv(1);
-	if (!*s || level.time < 30)
+	map = NULL;
+	if (*s && level.time >= 30)
+		map = G_FindMap(s);
+	if (!map)
 	{
-		char	small[64];
-		char	large[1280];
-
-		large[0] = 0;
-		map_loop
+		i = atoi(s);
+		if (*s && (i < 1 || i > vote_pages) && level.time >= 30)
 		{
-			if (maplist[i].name)
-			{
-				Com_sprintf(small, sizeof(small), "%s\n", maplist[i].name);
-				if (strlen(small) + strlen(large) > sizeof(large) - 100)
-				{
-					strcat(large, "...\n");
-					break;
-				}
-				else
-					strcat(large, small);
-			}
-			else
-				break;
+			gi.cprintf(ent, PRINT_HIGH, "Unknown map %s.\n", s);
+			return;
 		}
-		gi.cprintf(ent, PRINT_HIGH, "%s\nvote <map> : vote for next map\n", large);
+		if (i < 1 || i > vote_pages)
+			i = 1;
+		gi.cprintf(ent, PRINT_HIGH, "%s\nvote <map> : vote for next map\n", (char*)vote_text.data + vote_page[i - 1]);
+		if (vote_pages > 1)
+			gi.cprintf(ent, PRINT_HIGH, "vote <1-%d> : list more maps, this is %d\n", vote_pages, i);
 		return;
 	}
 
-	map_loop
 	{
-		if (!maplist[i].name)
-			break;
-		if (_stricmp(maplist[i].name, s) == 0)
-		{
-			int	needed;
+		int	needed;
 
-			ent->client->resp.vote = i;
-			needed = mapCount();
-			if (needed)
-				gi.bprintf(PRINT_HIGH, "%s votes for %s; %d more votes needed.\n", ent->client->pers.netname, maplist[i].name, needed);
-			else
-			{
-				gi.bprintf(PRINT_HIGH, "%s votes for %s.\n", ent->client->pers.netname, maplist[i].name);
-				lame_hack |= end_vote;
-			}
-			return;
+		i = map - config.maps;
+		freezeVote(ent->client, i);
+		G_JournalText(JE_VOTE, ent, ent->client->resp.team, i, map->name);
+		needed = mapCount();
+		if (needed)
+			gi.bprintf(PRINT_HIGH, "%s votes for %s; %d more votes needed.\n", ent->client->pers.netname, map->name, needed);
+		else
+		{
+			gi.bprintf(PRINT_HIGH, "%s votes for %s.\n", ent->client->pers.netname, map->name);
+			lame_hack |= end_vote;
 		}
 	}
-	gi.cprintf(ent, PRINT_HIGH, "Unknown map %s.\n", s);
 }
 
 static void mapLight()
 {
-	int	i;
+	mapentry_t*	map;
 
-	map_loop
+	map = G_FindMap(level.mapname);
+	if (!map)
 	{
-		if (!maplist[i].name)
-			break;
-		if (_stricmp(level.mapname, maplist[i].name) == 0)
-		{
-			switch (maplist[i].light)
-			{
-			case 1:
-				gi.configstring(CS_LIGHTS + 0, "a");
-				break;
-			case 2:
-				gi.configstring(CS_LIGHTS + 0, "b");
-				break;
-			case 3:
-				gi.configstring(CS_LIGHTS + 0, "c");
-				break;
-			case 4:
-				gi.configstring(CS_LIGHTS + 0, "d");
-				break;
-			case 5:
-				gi.configstring(CS_LIGHTS + 0, "e");
-				break;
-			case 6:
-				gi.configstring(CS_LIGHTS + 0, "f");
-				break;
-			case 7:
-				gi.configstring(CS_LIGHTS + 0, "g");
-				break;
-			case 8:
-				gi.configstring(CS_LIGHTS + 0, "h");
-				break;
-			case 9:
-				gi.configstring(CS_LIGHTS + 0, "i");
-				break;
-			case 10:
-				gi.configstring(CS_LIGHTS + 0, "j");
-				break;
-			default:
-				gi.configstring(CS_LIGHTS + 0, "m");
-				break;
-			}
+		gi.configstring(CS_LIGHTS + 0, "m");
+		return;
+	}
 
-			if (maplist[i].hook)
-				lame_hack |= mapnohook;
-			else
-				lame_hack &= ~mapnohook;
+	switch (map->light)
+	{
+	case 1:
+		gi.configstring(CS_LIGHTS + 0, "a");
+		break;
+	case 2:
+		gi.configstring(CS_LIGHTS + 0, "b");
+		break;
+	case 3:
+		gi.configstring(CS_LIGHTS + 0, "c");
+		break;
+	case 4:
+		gi.configstring(CS_LIGHTS + 0, "d");
+		break;
+	case 5:
+		gi.configstring(CS_LIGHTS + 0, "e");
+		break;
+	case 6:
+		gi.configstring(CS_LIGHTS + 0, "f");
+		break;
+	case 7:
+		gi.configstring(CS_LIGHTS + 0, "g");
+		break;
+	case 8:
+		gi.configstring(CS_LIGHTS + 0, "h");
+		break;
+	case 9:
+		gi.configstring(CS_LIGHTS + 0, "i");
+		break;
+	case 10:
+		gi.configstring(CS_LIGHTS + 0, "j");
+		break;
+	default:
+		gi.configstring(CS_LIGHTS + 0, "m");
+		break;
+	}
 
-			if (maplist[i].gravity && _stricmp(maplist[i].gravity, "0"))
-				gi.cvar_set("sv_gravity", maplist[i].gravity);
-			else
-				gi.cvar_set("sv_gravity", "800");
+	if (map->hook)
+		lame_hack |= mapnohook;
+	else
+		lame_hack &= ~mapnohook;
 
-			return;
+	if (map->gravity && _stricmp(map->gravity, "0"))
+		gi.cvar_set("sv_gravity", map->gravity);
+	else
+		gi.cvar_set("sv_gravity", "800");
+}
+
+static void loadArenas()
+{
+	int	i, n, team_max_count;
+	arenaentry_t*	entry;
+	arenanode*	arena;
+
+	numarenas = 0;
+	for (i = 0, entry = config.arenas; i < config.numarenas; i++, entry++)
+	{
+		if (Q_stricmp(entry->map, level.mapname))
+			continue;
+		if (numarenas == MAX_ARENAS)
+		{
+			gi.dprintf("%s has more than %d arenas\n", level.mapname, MAX_ARENAS);
+			break;
 		}
+		arena = &arenas[numarenas++];
+		arena->bounded = true;
+		VectorCopy(entry->mins, arena->mins);
+		VectorCopy(entry->maxs, arena->maxs);
+	}
+	if (!numarenas)
+	{
+		arenas[0].bounded = false;
+		numarenas = 1;
+	}
+
+	for (arena = arenas; arena < arenas + numarenas; arena++)
+	{
+		team_max_count = arena->team_max_count;
+		memset(arena->freeze, 0, sizeof(arena->freeze));
+		team_loop
+			arena->freeze[i].update = true;
+		arena->team_max_count = team_max_count;
+		arena->lame_hack = 0;
+		arena->ready_time = far_off;
 	}
-	gi.configstring(CS_LIGHTS + 0, "m");
+
+	// spread whoever is coming over to this map over its arenas
+	n = 0;
+	for (i = 0; i < game.maxclients; i++)
+		game.clients[i].resp.arena = game.clients[i].pers.connected ? n++ % numarenas : 0;
 }
 
 void freezeSpawn()
 {
-	int	i;
-
-	loadMessage();
-	loadMap();
+	// normally prefetched at intermission, so this doesn't touch the disk
+	if (G_LoadConfig())
+	{
+		loadMessage();
+		loadVote();
+	}
+	voteReset();
+	G_JournalText(JE_MATCH, NULL, none, 0, level.mapname);
 
-	memset(freeze, 0, sizeof(freeze));
-	team_loop
-		freeze[i].update = true;
-	lame_hack &= ~everyone_ready;
-	ready_time = far_off;
+	loadArenas();
 	gib_queue = 0;
 
 	moan[0] = gi.soundindex("insane/insane1.wav");
@@ -2495,49 +3073,121 @@ void freezeSpawn()
 	gi.configstring(CS_GENERAL + 5, ">");
 }
 
+// only spawns in the client's own arena, or anywhere for no client
+qboolean freezeSpot(edict_t* spot, edict_t* ent)
+{
+	arenanode*	arena;
+	int	j;
+
+	if (!ent)
+		return true;
+	arena = arena_of(ent);
+	if (!arena->bounded)
+		return true;
+	for (j = 0; j < 3; j++)
+		if (spot->s.origin[j] < arena->mins[j] || spot->s.origin[j] > arena->maxs[j])
+			return false;
+	return true;
+}
+
+// the arena with the fewest players, for someone connecting
+int freezeArena()
+{
+	int	i, best;
+	int	total[MAX_ARENAS];
+	edict_t*	other;
+
+	for (i = 0; i < numarenas; i++)
+		total[i] = 0;
+	game_loop
+	{
+		other = g_edicts + 1 + i;
+		if (!other->inuse)
+			continue;
+		total[other->client->resp.arena]++;
+	}
+	best = 0;
+	for (i = 1; i < numarenas; i++)
+		if (total[i] < total[best])
+			best = i;
+	return best;
+}
+
+void cmdArena(edict_t* ent)
+{
+	char*	s;
+	int	n, i;
+	int	total[MAX_ARENAS];
+	edict_t*	other;
+	arenanode*	arena = arena_of(ent);
+
+	s = gi.argv(1);
+	if (!*s || ent->client->frozen)
+	{
+		for (i = 0; i < numarenas; i++)
+			total[i] = 0;
+		game_loop
+		{
+			other = g_edicts + 1 + i;
+			if (other->inuse)
+				total[other->client->resp.arena]++;
+		}
+		for (i = 0; i < numarenas; i++)
+			gi.cprintf(ent, PRINT_HIGH, "%s arena %d: %d players\n", arenas + i == arena ? ">" : " ", i + 1, total[i]);
+		if (numarenas > 1)
+			gi.cprintf(ent, PRINT_HIGH, "arena <1-%d> : play in another arena\n", numarenas);
+		return;
+	}
+	n = atoi(s) - 1;
+	if (n < 0 || n >= numarenas)
+	{
+		gi.cprintf(ent, PRINT_HIGH, "Unknown arena %s.\n", s);
+		return;
+	}
+	if (arenas + n == arena)
+	{
+		gi.cprintf(ent, PRINT_HIGH, "You are already in arena %d.\n", n + 1);
+		return;
+	}
+	arena->freeze[ent->client->resp.team].update = true;
+	ent->client->resp.arena = n;
+	arenas[n].freeze[ent->client->resp.team].update = true;
+	if (!ent->client->resp.spectator && ent->health > 0)
+	{
+		ent->flags &= ~FL_GODMODE;
+		ent->health = 0;
+		meansOfDeath = MOD_SUICIDE;
+		player_die(ent, ent, ent, 100000, vec3_origin);
+	}
+	arenaPrintf(arena, "%s left for arena %d.\n", ent->client->pers.netname, n + 1);
+	arenaPrintf(&arenas[n], "%s joined arena %d.\n", ent->client->pers.netname, n + 1);
+}
+
 qboolean freezeMap()
 {
 	int	i;
+	mapentry_t*	map;
 
-	if (!maplist[0].name)
+	if (!config.nummaps)
 		return false;
 
 	if (lame_hack &end_vote)
 	{
-		int	j;
-		edict_t*	other;
-		int	vote_count;
-		int	best_count, best_map;
+		int	n;
 
 		lame_hack &= ~end_vote;
 
-		best_count = best_map = -1;
-		map_loop
-		{
-			if (!maplist[i].name)
-				break;
-			vote_count = 0;
-			for (j = 0; j < game.maxclients; j++)
-			{
-				other = g_edicts + 1 + j;
-				if (!other->inuse)
-					continue;
-				if (other->client->resp.vote == i)
-					vote_count++;
-			}
-			if (vote_count >= best_count)
-			{
-				if (vote_count == best_count && rand() &1)
-					continue;
-				best_count = vote_count;
-				best_map = i;
-			}
-		}
-
-		if (best_map != -1 && maplist[best_map].name)
-		{
-			endMapIndex = best_map;
-			maplist[best_map].did = true;
+		// pick one of the maps tied for the lead
+		if (vote_max)
+		{
+			n = 0;
+			for (i = vote_bucket[vote_max]; i != -1; i = config.maps[i].votenext)
+				n++;
+			n = rand() %n;
+			for (i = vote_bucket[vote_max]; n--; i = config.maps[i].votenext)
+				;
+			endMapIndex = i;
+			config.maps[i].did = true;
 			return true;
 		}
 	}
@@ -2547,78 +3197,39 @@ qboolean freezeMap()
 		int	count = 0, n;
 
 		map_loop
-		{
-			if (maplist[i].name)
-			{
-				if (!maplist[i].did)
-					count++;
-			}
-			else
-				break;
-		}
+			if (!config.maps[i].did)
+				count++;
 		if (count == 0)
 		{
 			map_loop
-				maplist[i].did = false;
-			map_loop
-			{
-				if (maplist[i].name)
-					count++;
-				else
-					break;
-			}
+				config.maps[i].did = false;
+			count = config.nummaps;
 		}
 
 		n = (rand() %count) + 1;
 		count = 0;
 		map_loop
 		{
-			if (maplist[i].name)
-			{
-				if (maplist[i].did)
-					continue;
-				count++;
-				if (count == n)
-				{
-					endMapIndex = i;
-					maplist[i].did = true;
-					return true;
-				}
-			}
-			else
-				break;
-		}
-	}
-
-	map_loop
-	{
-		if (!maplist[i].name)
-		{
-			i--;
-			break;
-		}
-		if (_stricmp(level.mapname, maplist[i].name) == 0)
-		{
-			i++;
-			if (i < 63)
+			if (config.maps[i].did)
+				continue;
+			count++;
+			if (count == n)
 			{
-				if (!maplist[i].name)
-					i = 0;
+				endMapIndex = i;
+				config.maps[i].did = true;
+				return true;
 			}
-			break;
 		}
 	}
 
-	if (i >= 63)
-		i = 0;
-	if (maplist[i].name)
-	{
-		endMapIndex = i;
-		maplist[i].did = true;
-		return true;
-	}
+	map = G_FindMap(level.mapname);
+	if (map)
+		i = (map - config.maps + 1) % config.nummaps;
 	else
-		return false;
+		i = config.nummaps - 1;
+	endMapIndex = i;
+	config.maps[i].did = true;
+	return true;
 }
 
 void cvarFreeze()
@@ -2637,40 +3248,45 @@ void cvarFreeze()
 	vote_percent = gi.cvar("vote_percent", "0", 0);
 	use_ready = gi.cvar("use_ready", "0", 0);
 	grapple_wall = gi.cvar("grapple_wall", "1", 0);
+	flashlight_traces = gi.cvar("flashlight_traces", "8", 0);
 
 	lame_hack = 0;
+	G_PrefetchFile(G_ConfigName());
 }
 
 void cmdReady(edict_t* ent)
 {
 	int	i;
+	arenanode*	arena = arena_of(ent);
 
-	if (!use_ready->value || lame_hack &everyone_ready)
+	if (!use_ready->value || arena->lame_hack &everyone_ready)
 		return;
 	if (floodCheck(ent))
 		return;
 	if (ent->client->resp.spectator)
 		return;
-	if (freeze[ent->client->resp.team].ready)
+	if (arena->freeze[ent->client->resp.team].ready)
 	{
-		gi.bprintf(PRINT_HIGH, "%s is not ready.\n", ent->client->pers.netname);
-		freeze[ent->client->resp.team].ready = false;
-		ready_time = far_off;
+		arenaPrintf(arena, "%s is not ready.\n", ent->client->pers.netname);
+		arena->freeze[ent->client->resp.team].ready = false;
+		G_JournalEvent(JE_READY, ent, NULL, ent->client->resp.team, 0, 0);
+		arena->ready_time = far_off;
 		return;
 	}
 	else
 	{
-		gi.bprintf(PRINT_HIGH, "%s is ready to play.\n", ent->client->pers.netname);
-		freeze[ent->client->resp.team].ready = true;
+		arenaPrintf(arena, "%s is ready to play.\n", ent->client->pers.netname);
+		arena->freeze[ent->client->resp.team].ready = true;
+		G_JournalEvent(JE_READY, ent, NULL, ent->client->resp.team, 1, 0);
 	}
 	team_loop
 	{
-		if (!freeze[i].alive)
+		if (!arena->freeze[i].alive)
 			continue;
-		if (freeze[i].ready)
+		if (arena->freeze[i].ready)
 			continue;
-		ready_time = far_off;
+		arena->ready_time = far_off;
 		return;
 	}
-	ready_time = level.time + 16;
+	arena->ready_time = level.time + 16;
 }
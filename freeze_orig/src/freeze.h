@@ -1,19 +1,47 @@
-struct {
-	int	score;
-	int	thawed;
-	float	win_time;
-	qboolean	update;
-	float	last_update;
-	int	frozen;
-	int	alive;
-	float	break_time;
-	qboolean	ready;
-} freeze[5];
+#define	MAX_ARENAS	8
+
+// one match, a map can run several side by side in regions set in freeze.ini
+typedef struct {
+	struct {
+		int	score;
+		int	thawed;
+		float	win_time;
+		qboolean	update;
+		float	last_update;
+		int	frozen;
+		int	alive;
+		float	break_time;
+		qboolean	ready;
+	} freeze[5];
+	int	team_max_count;
+	int	lame_hack;	// everyone_ready
+	float	ready_time;
+	qboolean	bounded;	// only spawns inside mins and maxs
+	vec3_t	mins;
+	vec3_t	maxs;
+} arenanode;
+
+arenanode	arenas[MAX_ARENAS];
+int	numarenas;
+
+#define	arena_of(ent)	(&arenas[(ent)->client->resp.arena])
+
+#define	MAX_MENU_ROWS	24
+#define	MAX_MENU_LAYOUT	1400
+
+// a menu's layout strings, built once for every place the cursor can be
+typedef struct {
+	struct pnode*	entries;
+	int	num;
+	char*	strings;
+	char*	layout[MAX_MENU_ROWS + 1];	// by cursor row, the last with no cursor
+} pmenulayout;
 
 typedef struct hnode {
 	struct pnode*	entries;
 	int	cur;
 	int	num;
+	pmenulayout*	layout;
 } hndnode;
 
 typedef struct pnode {
@@ -23,14 +51,6 @@ typedef struct pnode {
 	void	(*selectfunc)(edict_t* ent, struct pnode* entry);
 } pmenunode;
 
-struct {
-	char*	name;
-	char*	gravity;
-	int	light;
-	qboolean	did;
-	qboolean	hook;
-} maplist[64];
-
 enum team_enum {
 	red, blue, green, yellow, none };
 static char*	freeze_team[] = {"Red", "Blue", "Green", "Yellow", "None"};
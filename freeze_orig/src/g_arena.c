@@ -0,0 +1,146 @@
+// g_arena.c -- level memory handed out from large blocks, and shared strings
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+Every string a map sets on an entity used to be its own TagMalloc, a zone
+block with its own header, and a big map has thousands of them.  They are
+now cut from ARENA_BLOCK sized TAG_LEVEL blocks, which gi.FreeTags takes
+away with the rest of the level, so G_ResetArena only has to forget them.
+
+Strings from G_InternString are kept once per level, every classname
+"info_player_deathmatch" is the same pointer.  Two interned strings are
+equal exactly when the pointers are, and they must never be written to.
+
+==============================================================================
+*/
+
+#define	ARENA_BLOCK		32768
+#define	ARENA_ALIGN		8
+#define	INTERN_HASH		1024		// power of two
+
+typedef struct intern_s
+{
+	struct intern_s	*next;
+	unsigned		hash;
+	char			string[1];		// as long as it needs
+} intern_t;
+
+static byte		*arena_p;			// free space in the current block
+static int		arena_left;
+static intern_t	**intern_hash;		// INTERN_HASH chains, from the arena
+
+static arenastats_t	arena;
+
+/*
+=================
+G_ResetArena
+
+Call once TAG_LEVEL has been freed.
+=================
+*/
+void G_ResetArena (void)
+{
+	arena_p = NULL;
+	arena_left = 0;
+	intern_hash = NULL;
+	memset (&arena, 0, sizeof(arena));
+}
+
+/*
+=================
+G_ArenaAlloc
+
+Cleared memory that lasts until the level ends.
+=================
+*/
+void *G_ArenaAlloc (int size)
+{
+	byte	*p;
+
+	size = (size + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+	arena.allocs++;
+	arena.used += size;
+
+	// big ones get a block to themselves rather than waste the rest of one
+	if (size > ARENA_BLOCK / 4)
+	{
+		arena.blocks++;
+		arena.bytes += size;
+		return G_TagMalloc (size, TAG_LEVEL, MEM_ARENA);
+	}
+
+	if (size > arena_left)
+	{
+		arena_p = G_TagMalloc (ARENA_BLOCK, TAG_LEVEL, MEM_ARENA);
+		arena_left = ARENA_BLOCK;
+		arena.blocks++;
+		arena.bytes += ARENA_BLOCK;
+	}
+
+	p = arena_p;
+	arena_p += size;
+	arena_left -= size;
+	return p;
+}
+
+/*
+=================
+G_InternString
+=================
+*/
+char *G_InternString (char *s)
+{
+	unsigned	hash;
+	intern_t	*in;
+	char		*c;
+	int			len;
+
+	hash = 0;
+	for (c = s ; *c ; c++)
+		hash = hash * 33 + *(byte *)c;
+	len = c - s + 1;
+
+	arena.strings++;
+	arena.stringbytes += len;
+
+	if (!intern_hash)
+		intern_hash = G_ArenaAlloc (INTERN_HASH * sizeof(*intern_hash));
+
+	for (in = intern_hash[hash & (INTERN_HASH-1)] ; in ; in = in->next)
+		if (in->hash == hash && !strcmp (in->string, s))
+			return in->string;
+
+	in = G_ArenaAlloc (sizeof(*in) + len - 1);
+	in->hash = hash;
+	memcpy (in->string, s, len);
+	in->next = intern_hash[hash & (INTERN_HASH-1)];
+	intern_hash[hash & (INTERN_HASH-1)] = in;
+	arena.unique++;
+	return in->string;
+}
+
+/*
+=================
+G_ArenaStats
+=================
+*/
+void G_ArenaStats (arenastats_t *stats)
+{
+	*stats = arena;
+}
+
+/*
+=================
+G_ArenaReport
+
+One line for the console after a level has spawned.
+=================
+*/
+void G_ArenaReport (void)
+{
+	gi.dprintf ("%i entity strings, %i unique, %i bytes in %i level blocks\n",
+		arena.strings, arena.unique, arena.bytes, arena.blocks);
+}
@@ -0,0 +1,1064 @@
+// g_bsp.c -- the game's own copy of the world collision model
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+gi.trace can only be called from the game thread, one trace at a time.
+The world brushes never change during a level, so SpawnEntities reads the
+map's .bsp into a copy that anything may trace against from any thread,
+with G_BspTrace, or in batches spread over the workers with
+G_BspTraceRays.
+
+Only the world model is loaded.  Brush entities, players and everything
+else are invisible to these traces, so a clear line here still needs a
+gi.trace if doors and the like matter, but a blocked one doesn't.
+
+The trace is the engine's own algorithm with the state passed around
+instead of kept in globals.  The engine also skips brushes it already
+tried in another leaf, these are just tried again, which gives the same
+answer.
+
+Set bsp_check to compare every batched trace against gi.trace, and use
+"sv bsp test <count>" to compare random traces across the map.
+
+==============================================================================
+*/
+
+#define	BSPVERSION		38
+
+#define	LUMP_PLANES			1
+#define	LUMP_NODES			4
+#define	LUMP_TEXINFO		5
+#define	LUMP_LEAFS			8
+#define	LUMP_LEAFBRUSHES	10
+#define	LUMP_MODELS			13
+#define	LUMP_BRUSHES		14
+#define	LUMP_BRUSHSIDES		15
+#define	HEADER_LUMPS		19
+
+#define	DIST_EPSILON	(0.03125)
+
+// on disk
+typedef struct
+{
+	int		fileofs, filelen;
+} lump_t;
+
+typedef struct
+{
+	int		ident;
+	int		version;
+	lump_t	lumps[HEADER_LUMPS];
+} dheader_t;
+
+typedef struct
+{
+	float	normal[3];
+	float	dist;
+	int		type;
+} dplane_t;
+
+typedef struct
+{
+	int		planenum;
+	int		children[2];	// negative numbers are -(leafs+1)
+	short	mins[3], maxs[3];
+	unsigned short	firstface, numfaces;
+} dnode_t;
+
+typedef struct
+{
+	float	vecs[2][4];
+	int		flags;
+	int		value;
+	char	texture[32];
+	int		nexttexinfo;
+} texinfo_t;
+
+typedef struct
+{
+	int		contents;
+	short	cluster, area;
+	short	mins[3], maxs[3];
+	unsigned short	firstleafface, numleaffaces;
+	unsigned short	firstleafbrush, numleafbrushes;
+} dleaf_t;
+
+typedef struct
+{
+	float	mins[3], maxs[3];
+	float	origin[3];
+	int		headnode;
+	int		firstface, numfaces;
+} dmodel_t;
+
+typedef struct
+{
+	int		firstside;
+	int		numsides;
+	int		contents;
+} dbrush_t;
+
+typedef struct
+{
+	unsigned short	planenum;
+	short	texinfo;
+} dbrushside_t;
+
+typedef struct
+{
+	char	name[56];
+	int		filepos, filelen;
+} dpackfile_t;
+
+typedef struct
+{
+	int		ident;
+	int		dirofs;
+	int		dirlen;
+} dpackheader_t;
+
+// in memory
+typedef struct
+{
+	cplane_t	*plane;
+	int			children[2];
+} bnode_t;
+
+typedef struct
+{
+	int			contents;
+	int			firstleafbrush;
+	int			numleafbrushes;
+} bleaf_t;
+
+typedef struct
+{
+	cplane_t	*plane;
+	csurface_t	*surface;
+} bside_t;
+
+typedef struct
+{
+	int			contents;
+	int			firstside;
+	int			numsides;
+} bbrush_t;
+
+typedef struct
+{
+	char		name[MAX_QPATH];
+	byte		*base;			// everything below is in this one block
+	int			size;
+
+	cplane_t	*planes;
+	int			numplanes;
+	bnode_t		*nodes;
+	int			numnodes;
+	bleaf_t		*leafs;
+	int			numleafs;
+	int			*leafbrushes;
+	int			numleafbrushes;
+	bbrush_t	*brushes;
+	int			numbrushes;
+	bside_t		*sides;
+	int			numsides;
+	csurface_t	*surfaces;
+	int			numsurfaces;
+
+	int			headnode;
+	vec3_t		mins, maxs;		// of the world model
+} bspworld_t;
+
+// one trace in progress
+typedef struct
+{
+	vec3_t		start, end;
+	vec3_t		mins, maxs;
+	vec3_t		extents;
+	int			contents;
+	qboolean	ispoint;
+	trace_t		trace;
+} btrace_t;
+
+typedef struct
+{
+	bspray_t	*rays;
+	int			contentmask;
+} bbatch_t;
+
+static bspworld_t	bsp;
+static csurface_t	bsp_nullsurface;
+
+static int	bsp_traces;
+static int	bsp_checks;
+static int	bsp_mismatches;
+
+cvar_t	*bsp_check;
+
+void G_InitBsp (void)
+{
+	bsp_check = gi.cvar ("bsp_check", "0", 0);
+}
+
+void G_FreeBsp (void)
+{
+	if (bsp.base)
+		free (bsp.base);
+	memset (&bsp, 0, sizeof(bsp));
+}
+
+/*
+==============================================================================
+
+LOADING
+
+==============================================================================
+*/
+
+/*
+=================
+B_ReadPak
+
+Looks for name in a pak file, the same way the engine does.
+=================
+*/
+static byte *B_ReadPak (char *pakname, char *name, int *length)
+{
+	FILE			*f;
+	dpackheader_t	header;
+	dpackfile_t		*dir;
+	byte			*data;
+	int				i, count;
+
+	f = fopen (pakname, "rb");
+	if (!f)
+		return NULL;
+
+	data = NULL;
+	dir = NULL;
+	if (fread (&header, sizeof(header), 1, f) != 1
+		|| LittleLong (header.ident) != (('K'<<24)+('C'<<16)+('A'<<8)+'P'))
+		goto done;
+
+	count = LittleLong (header.dirlen) / sizeof(dpackfile_t);
+	if (count <= 0)
+		goto done;
+	dir = malloc (count * sizeof(dpackfile_t));
+	if (!dir || fseek (f, LittleLong (header.dirofs), SEEK_SET)
+		|| fread (dir, sizeof(dpackfile_t), count, f) != count)
+		goto done;
+
+	for (i=0 ; i<count ; i++)
+	{
+		dir[i].name[sizeof(dir[i].name)-1] = 0;
+		if (Q_stricmp (dir[i].name, name))
+			continue;
+		*length = LittleLong (dir[i].filelen);
+		data = malloc (*length ? *length : 1);
+		if (data && (fseek (f, LittleLong (dir[i].filepos), SEEK_SET)
+			|| fread (data, *length, 1, f) != 1))
+		{
+			free (data);
+			data = NULL;
+		}
+		break;
+	}
+
+done:
+	if (dir)
+		free (dir);
+	fclose (f);
+	return data;
+}
+
+static byte *B_ReadLoose (char *filename, int *length)
+{
+	FILE	*f;
+	byte	*data;
+	int		len;
+
+	f = fopen (filename, "rb");
+	if (!f)
+		return NULL;
+	fseek (f, 0, SEEK_END);
+	len = ftell (f);
+	fseek (f, 0, SEEK_SET);
+	data = NULL;
+	if (len > 0 && (data = malloc (len)) != NULL && fread (data, len, 1, f) != 1)
+	{
+		free (data);
+		data = NULL;
+	}
+	fclose (f);
+	*length = len;
+	return data;
+}
+
+/*
+=================
+B_ReadMap
+
+The game directory first, then baseq2, then baseq2 on the cd if there is
+one, and in each the highest numbered pak first, then the loose files,
+the same order the engine searches.  Like the engine they are under
+basedir, not wherever the server happened to be started from.  The
+engine has just read the same file, so this doesn't wait on the disk.
+=================
+*/
+static byte *B_ReadMap (char *name, int *length)
+{
+	char	dirs[3][MAX_OSPATH];
+	char	path[MAX_OSPATH];
+	cvar_t	*game, *basedir, *cddir;
+	byte	*data;
+	int		d, i, numdirs;
+
+	game = gi.cvar ("game", "", 0);
+	basedir = gi.cvar ("basedir", ".", CVAR_NOSET);
+	cddir = gi.cvar ("cddir", "", CVAR_NOSET);
+
+	numdirs = 0;
+	if (*game->string && Q_stricmp (game->string, "baseq2"))
+		Com_sprintf (dirs[numdirs++], sizeof(dirs[0]), "%s/%s", basedir->string, game->string);
+	Com_sprintf (dirs[numdirs++], sizeof(dirs[0]), "%s/baseq2", basedir->string);
+	if (*cddir->string)
+		Com_sprintf (dirs[numdirs++], sizeof(dirs[0]), "%s/baseq2", cddir->string);
+
+	for (d=0 ; d<numdirs ; d++)
+	{
+		for (i=9 ; i>=0 ; i--)
+		{
+			Com_sprintf (path, sizeof(path), "%s/pak%i.pak", dirs[d], i);
+			data = B_ReadPak (path, name, length);
+			if (data)
+				return data;
+		}
+		Com_sprintf (path, sizeof(path), "%s/%s", dirs[d], name);
+		data = B_ReadLoose (path, length);
+		if (data)
+			return data;
+	}
+	return NULL;
+}
+
+static void *B_Lump (byte *file, int filelen, dheader_t *header, int lump, int size, int *count)
+{
+	int		ofs, len;
+
+	ofs = LittleLong (header->lumps[lump].fileofs);
+	len = LittleLong (header->lumps[lump].filelen);
+	if (ofs < 0 || len < 0 || ofs + len > filelen || len % size)
+		return NULL;
+	*count = len / size;
+	return file + ofs;
+}
+
+/*
+=================
+B_BuildWorld
+
+Converts the lumps of a loaded .bsp into bsp.  Returns an error message,
+or NULL on success.
+=================
+*/
+static char *B_BuildWorld (byte *file, int filelen)
+{
+	dheader_t		*header;
+	dplane_t		*dplanes;
+	dnode_t			*dnodes;
+	texinfo_t		*dtexinfo;
+	dleaf_t			*dleafs;
+	unsigned short	*dleafbrushes;
+	dmodel_t		*dmodels;
+	dbrush_t		*dbrushes;
+	dbrushside_t	*dsides;
+	int				nummodels = 0, i, j, n;
+	byte			*p;
+
+	if (filelen < sizeof(dheader_t))
+		return "file too short";
+	header = (dheader_t *)file;
+	if (LittleLong (header->ident) != (('P'<<24)+('S'<<16)+('B'<<8)+'I'))
+		return "not a bsp file";
+	if (LittleLong (header->version) != BSPVERSION)
+		return "wrong version";
+
+	dplanes = B_Lump (file, filelen, header, LUMP_PLANES, sizeof(dplane_t), &bsp.numplanes);
+	dnodes = B_Lump (file, filelen, header, LUMP_NODES, sizeof(dnode_t), &bsp.numnodes);
+	dtexinfo = B_Lump (file, filelen, header, LUMP_TEXINFO, sizeof(texinfo_t), &bsp.numsurfaces);
+	dleafs = B_Lump (file, filelen, header, LUMP_LEAFS, sizeof(dleaf_t), &bsp.numleafs);
+	dleafbrushes = B_Lump (file, filelen, header, LUMP_LEAFBRUSHES, sizeof(unsigned short), &bsp.numleafbrushes);
+	dmodels = B_Lump (file, filelen, header, LUMP_MODELS, sizeof(dmodel_t), &nummodels);
+	dbrushes = B_Lump (file, filelen, header, LUMP_BRUSHES, sizeof(dbrush_t), &bsp.numbrushes);
+	dsides = B_Lump (file, filelen, header, LUMP_BRUSHSIDES, sizeof(dbrushside_t), &bsp.numsides);
+	if (!dplanes || !dnodes || !dtexinfo || !dleafs || !dleafbrushes || !dmodels || !dbrushes || !dsides)
+		return "bad lump";
+	if (!bsp.numnodes || !bsp.numleafs || !nummodels)
+		return "no world model";
+
+	// one block for everything, the lumps are all small
+	bsp.size = bsp.numplanes * sizeof(cplane_t)
+		+ bsp.numnodes * sizeof(bnode_t)
+		+ bsp.numleafs * sizeof(bleaf_t)
+		+ bsp.numleafbrushes * sizeof(int)
+		+ bsp.numbrushes * sizeof(bbrush_t)
+		+ bsp.numsides * sizeof(bside_t)
+		+ bsp.numsurfaces * sizeof(csurface_t);
+	bsp.base = malloc (bsp.size);
+	if (!bsp.base)
+		return "out of memory";
+	p = bsp.base;
+	bsp.planes = (cplane_t *)p;		p += bsp.numplanes * sizeof(cplane_t);
+	bsp.nodes = (bnode_t *)p;		p += bsp.numnodes * sizeof(bnode_t);
+	bsp.leafs = (bleaf_t *)p;		p += bsp.numleafs * sizeof(bleaf_t);
+	bsp.leafbrushes = (int *)p;		p += bsp.numleafbrushes * sizeof(int);
+	bsp.brushes = (bbrush_t *)p;	p += bsp.numbrushes * sizeof(bbrush_t);
+	bsp.sides = (bside_t *)p;		p += bsp.numsides * sizeof(bside_t);
+	bsp.surfaces = (csurface_t *)p;
+
+	for (i=0 ; i<bsp.numplanes ; i++)
+	{
+		for (j=0 ; j<3 ; j++)
+			bsp.planes[i].normal[j] = LittleFloat (dplanes[i].normal[j]);
+		bsp.planes[i].dist = LittleFloat (dplanes[i].dist);
+		bsp.planes[i].type = LittleLong (dplanes[i].type);
+		bsp.planes[i].signbits = 0;
+		for (j=0 ; j<3 ; j++)
+			if (bsp.planes[i].normal[j] < 0)
+				bsp.planes[i].signbits |= 1<<j;
+	}
+
+	for (i=0 ; i<bsp.numsurfaces ; i++)
+	{
+		strncpy (bsp.surfaces[i].name, dtexinfo[i].texture, sizeof(bsp.surfaces[i].name)-1);
+		bsp.surfaces[i].name[sizeof(bsp.surfaces[i].name)-1] = 0;
+		bsp.surfaces[i].flags = LittleLong (dtexinfo[i].flags);
+		bsp.surfaces[i].value = LittleLong (dtexinfo[i].value);
+	}
+
+	for (i=0 ; i<bsp.numnodes ; i++)
+	{
+		n = LittleLong (dnodes[i].planenum);
+		if (n < 0 || n >= bsp.numplanes)
+			return "bad node plane";
+		bsp.nodes[i].plane = bsp.planes + n;
+		for (j=0 ; j<2 ; j++)
+		{
+			n = LittleLong (dnodes[i].children[j]);
+			if (n >= bsp.numnodes || -1-n >= bsp.numleafs)
+				return "bad node child";
+			bsp.nodes[i].children[j] = n;
+		}
+	}
+
+	for (i=0 ; i<bsp.numleafs ; i++)
+	{
+		bsp.leafs[i].contents = LittleLong (dleafs[i].contents);
+		bsp.leafs[i].firstleafbrush = (unsigned short)LittleShort (dleafs[i].firstleafbrush);
+		bsp.leafs[i].numleafbrushes = (unsigned short)LittleShort (dleafs[i].numleafbrushes);
+		if (bsp.leafs[i].firstleafbrush + bsp.leafs[i].numleafbrushes > bsp.numleafbrushes)
+			return "bad leaf brushes";
+	}
+
+	for (i=0 ; i<bsp.numleafbrushes ; i++)
+	{
+		bsp.leafbrushes[i] = (unsigned short)LittleShort (dleafbrushes[i]);
+		if (bsp.leafbrushes[i] >= bsp.numbrushes)
+			return "bad leaf brush";
+	}
+
+	for (i=0 ; i<bsp.numbrushes ; i++)
+	{
+		bsp.brushes[i].firstside = LittleLong (dbrushes[i].firstside);
+		bsp.brushes[i].numsides = LittleLong (dbrushes[i].numsides);
+		bsp.brushes[i].contents = LittleLong (dbrushes[i].contents);
+		if (bsp.brushes[i].firstside < 0 || bsp.brushes[i].numsides < 0
+			|| bsp.brushes[i].firstside + bsp.brushes[i].numsides > bsp.numsides)
+			return "bad brush sides";
+	}
+
+	for (i=0 ; i<bsp.numsides ; i++)
+	{
+		n = (unsigned short)LittleShort (dsides[i].planenum);
+		if (n >= bsp.numplanes)
+			return "bad side plane";
+		bsp.sides[i].plane = bsp.planes + n;
+		n = LittleShort (dsides[i].texinfo);
+		if (n >= bsp.numsurfaces)
+			return "bad side texinfo";
+		bsp.sides[i].surface = n < 0 ? &bsp_nullsurface : bsp.surfaces + n;
+	}
+
+	bsp.headnode = LittleLong (dmodels[0].headnode);
+	if (bsp.headnode < 0 || bsp.headnode >= bsp.numnodes)
+		return "bad world model";
+	for (j=0 ; j<3 ; j++)
+	{
+		bsp.mins[j] = LittleFloat (dmodels[0].mins[j]);
+		bsp.maxs[j] = LittleFloat (dmodels[0].maxs[j]);
+	}
+	return NULL;
+}
+
+/*
+=================
+G_LoadBsp
+
+Called from SpawnEntities.  If the map can't be read the traces here all
+come back clear, so callers fall back to gi.trace.
+=================
+*/
+void G_LoadBsp (char *mapname)
+{
+	char	name[MAX_QPATH];
+	byte	*file;
+	char	*error;
+	int		length;
+
+	if (bsp.base && !Q_stricmp (bsp.name, mapname))
+		return;		// same map again
+	G_FreeBsp ();
+
+	Swap_Init ();
+
+	Com_sprintf (name, sizeof(name), "maps/%s.bsp", mapname);
+	file = B_ReadMap (name, &length);
+	if (!file)
+	{
+		gi.dprintf ("G_LoadBsp: couldn't find %s, traces aren't culled on this map\n", name);
+		return;
+	}
+
+	error = B_BuildWorld (file, length);
+	free (file);
+	if (error)
+	{
+		gi.dprintf ("G_LoadBsp: %s: %s, traces aren't culled on this map\n", name, error);
+		G_FreeBsp ();
+		return;
+	}
+	strncpy (bsp.name, mapname, sizeof(bsp.name)-1);
+}
+
+qboolean G_BspLoaded (void)
+{
+	return bsp.base != NULL;
+}
+
+/*
+==============================================================================
+
+TRACING
+
+==============================================================================
+*/
+
+/*
+=================
+G_BspPointContents
+
+The contents of the world at p, without any entities.
+=================
+*/
+int G_BspPointContents (vec3_t p)
+{
+	int			num;
+	cplane_t	*plane;
+	float		d;
+
+	if (!bsp.base)
+		return 0;
+
+	num = bsp.headnode;
+	while (num >= 0)
+	{
+		plane = bsp.nodes[num].plane;
+		if (plane->type < 3)
+			d = p[plane->type] - plane->dist;
+		else
+			d = DotProduct (plane->normal, p) - plane->dist;
+		num = bsp.nodes[num].children[d < 0];
+	}
+	return bsp.leafs[-1-num].contents;
+}
+
+static void B_ClipBoxToBrush (btrace_t *bt, bbrush_t *brush)
+{
+	int			i, j;
+	cplane_t	*plane, *clipplane;
+	float		dist;
+	float		enterfrac, leavefrac;
+	vec3_t		ofs;
+	float		d1, d2;
+	qboolean	getout, startout;
+	float		f;
+	bside_t		*side, *leadside;
+
+	enterfrac = -1;
+	leavefrac = 1;
+	clipplane = NULL;
+	leadside = NULL;
+	getout = false;
+	startout = false;
+
+	if (!brush->numsides)
+		return;
+
+	for (i=0 ; i<brush->numsides ; i++)
+	{
+		side = &bsp.sides[brush->firstside + i];
+		plane = side->plane;
+
+		if (!bt->ispoint)
+		{	// push the plane out apropriately for mins/maxs
+			for (j=0 ; j<3 ; j++)
+			{
+				if (plane->normal[j] < 0)
+					ofs[j] = bt->maxs[j];
+				else
+					ofs[j] = bt->mins[j];
+			}
+			dist = plane->dist - DotProduct (ofs, plane->normal);
+		}
+		else
+			dist = plane->dist;
+
+		d1 = DotProduct (bt->start, plane->normal) - dist;
+		d2 = DotProduct (bt->end, plane->normal) - dist;
+
+		if (d2 > 0)
+			getout = true;	// endpoint is not in solid
+		if (d1 > 0)
+			startout = true;
+
+		// if completely in front of face, no intersection
+		if (d1 > 0 && d2 >= d1)
+			return;
+		if (d1 <= 0 && d2 <= 0)
+			continue;
+
+		// crosses face
+		if (d1 > d2)
+		{	// enter
+			f = (d1-DIST_EPSILON) / (d1-d2);
+			if (f > enterfrac)
+			{
+				enterfrac = f;
+				clipplane = plane;
+				leadside = side;
+			}
+		}
+		else
+		{	// leave
+			f = (d1+DIST_EPSILON) / (d1-d2);
+			if (f < leavefrac)
+				leavefrac = f;
+		}
+	}
+
+	if (!startout)
+	{	// original point was inside brush
+		bt->trace.startsolid = true;
+		if (!getout)
+			bt->trace.allsolid = true;
+		return;
+	}
+	if (enterfrac < leavefrac && enterfrac > -1 && enterfrac < bt->trace.fraction)
+	{
+		if (enterfrac < 0)
+			enterfrac = 0;
+		bt->trace.fraction = enterfrac;
+		bt->trace.plane = *clipplane;
+		bt->trace.surface = leadside->surface;
+		bt->trace.contents = brush->contents;
+	}
+}
+
+static void B_TestBoxInBrush (btrace_t *bt, bbrush_t *brush)
+{
+	int			i, j;
+	cplane_t	*plane;
+	vec3_t		ofs;
+	float		dist;
+
+	if (!brush->numsides)
+		return;
+
+	for (i=0 ; i<brush->numsides ; i++)
+	{
+		plane = bsp.sides[brush->firstside + i].plane;
+		for (j=0 ; j<3 ; j++)
+		{
+			if (plane->normal[j] < 0)
+				ofs[j] = bt->maxs[j];
+			else
+				ofs[j] = bt->mins[j];
+		}
+		dist = plane->dist - DotProduct (ofs, plane->normal);
+
+		// if completely in front of face, no intersection
+		if (DotProduct (bt->start, plane->normal) - dist > 0)
+			return;
+	}
+
+	// inside this brush
+	bt->trace.startsolid = bt->trace.allsolid = true;
+	bt->trace.fraction = 0;
+	bt->trace.contents = brush->contents;
+}
+
+static void B_TraceToLeaf (btrace_t *bt, int leafnum, qboolean test)
+{
+	bleaf_t		*leaf;
+	bbrush_t	*b;
+	int			k;
+
+	leaf = &bsp.leafs[leafnum];
+	if (!(leaf->contents & bt->contents))
+		return;
+
+	for (k=0 ; k<leaf->numleafbrushes ; k++)
+	{
+		b = &bsp.brushes[bsp.leafbrushes[leaf->firstleafbrush + k]];
+		if (!(b->contents & bt->contents))
+			continue;
+		if (test)
+		{
+			B_TestBoxInBrush (bt, b);
+			if (bt->trace.allsolid)
+				return;
+		}
+		else
+		{
+			B_ClipBoxToBrush (bt, b);
+			if (!bt->trace.fraction)
+				return;
+		}
+	}
+}
+
+// the position test, every leaf the box touches
+static void B_TestInLeafs_r (btrace_t *bt, int num, vec3_t mins, vec3_t maxs)
+{
+	bnode_t		*node;
+	int			s;
+
+	while (!bt->trace.allsolid)
+	{
+		if (num < 0)
+		{
+			B_TraceToLeaf (bt, -1-num, true);
+			return;
+		}
+		node = &bsp.nodes[num];
+		s = BoxOnPlaneSide (mins, maxs, node->plane);
+		if (s == 1)
+			num = node->children[0];
+		else if (s == 2)
+			num = node->children[1];
+		else
+		{	// go down both
+			B_TestInLeafs_r (bt, node->children[0], mins, maxs);
+			num = node->children[1];
+		}
+	}
+}
+
+static void B_RecursiveHullCheck (btrace_t *bt, int num, float p1f, float p2f, vec3_t p1, vec3_t p2)
+{
+	bnode_t		*node;
+	cplane_t	*plane;
+	float		t1, t2, offset;
+	float		frac, frac2;
+	float		idist;
+	int			i;
+	vec3_t		mid;
+	int			side;
+	float		midf;
+
+	if (bt->trace.fraction <= p1f)
+		return;		// already hit something nearer
+
+	// if < 0, we are in a leaf node
+	if (num < 0)
+	{
+		B_TraceToLeaf (bt, -1-num, false);
+		return;
+	}
+
+	// find the point distances to the seperating plane
+	// and the offset for the size of the box
+	node = &bsp.nodes[num];
+	plane = node->plane;
+
+	if (plane->type < 3)
+	{
+		t1 = p1[plane->type] - plane->dist;
+		t2 = p2[plane->type] - plane->dist;
+		offset = bt->extents[plane->type];
+	}
+	else
+	{
+		t1 = DotProduct (plane->normal, p1) - plane->dist;
+		t2 = DotProduct (plane->normal, p2) - plane->dist;
+		if (bt->ispoint)
+			offset = 0;
+		else
+			offset = fabs(bt->extents[0]*plane->normal[0])
+				+ fabs(bt->extents[1]*plane->normal[1])
+				+ fabs(bt->extents[2]*plane->normal[2]);
+	}
+
+	// see which sides we need to consider
+	if (t1 >= offset && t2 >= offset)
+	{
+		B_RecursiveHullCheck (bt, node->children[0], p1f, p2f, p1, p2);
+		return;
+	}
+	if (t1 < -offset && t2 < -offset)
+	{
+		B_RecursiveHullCheck (bt, node->children[1], p1f, p2f, p1, p2);
+		return;
+	}
+
+	// put the crosspoint DIST_EPSILON pixels on the near side
+	if (t1 < t2)
+	{
+		idist = 1.0/(t1-t2);
+		side = 1;
+		frac2 = (t1 + offset + DIST_EPSILON)*idist;
+		frac = (t1 - offset + DIST_EPSILON)*idist;
+	}
+	else if (t1 > t2)
+	{
+		idist = 1.0/(t1-t2);
+		side = 0;
+		frac2 = (t1 - offset - DIST_EPSILON)*idist;
+		frac = (t1 + offset + DIST_EPSILON)*idist;
+	}
+	else
+	{
+		side = 0;
+		frac = 1;
+		frac2 = 0;
+	}
+
+	// move up to the node
+	if (frac < 0)
+		frac = 0;
+	if (frac > 1)
+		frac = 1;
+	midf = p1f + (p2f - p1f)*frac;
+	for (i=0 ; i<3 ; i++)
+		mid[i] = p1[i] + frac*(p2[i] - p1[i]);
+	B_RecursiveHullCheck (bt, node->children[side], p1f, midf, p1, mid);
+
+	// go past the node
+	if (frac2 < 0)
+		frac2 = 0;
+	if (frac2 > 1)
+		frac2 = 1;
+	midf = p1f + (p2f - p1f)*frac2;
+	for (i=0 ; i<3 ; i++)
+		mid[i] = p1[i] + frac2*(p2[i] - p1[i]);
+	B_RecursiveHullCheck (bt, node->children[side^1], midf, p2f, mid, p2);
+}
+
+/*
+=================
+G_BspTrace
+
+gi.trace against the world alone.  Safe to call from any thread.
+=================
+*/
+trace_t G_BspTrace (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int contentmask)
+{
+	btrace_t	bt;
+	vec3_t		c1, c2;
+	int			i;
+
+	if (!mins)
+		mins = vec3_origin;
+	if (!maxs)
+		maxs = vec3_origin;
+
+	memset (&bt.trace, 0, sizeof(bt.trace));
+	bt.trace.fraction = 1;
+	bt.trace.surface = &bsp_nullsurface;
+	bt.trace.ent = g_edicts;
+
+	if (!bsp.base)
+	{
+		VectorCopy (end, bt.trace.endpos);
+		return bt.trace;
+	}
+
+	bt.contents = contentmask;
+	VectorCopy (start, bt.start);
+	VectorCopy (end, bt.end);
+	VectorCopy (mins, bt.mins);
+	VectorCopy (maxs, bt.maxs);
+
+	// check for position test special case
+	if (VectorCompare (start, end))
+	{
+		VectorAdd (start, mins, c1);
+		VectorAdd (start, maxs, c2);
+		for (i=0 ; i<3 ; i++)
+		{
+			c1[i] -= 1;
+			c2[i] += 1;
+		}
+		B_TestInLeafs_r (&bt, bsp.headnode, c1, c2);
+		VectorCopy (start, bt.trace.endpos);
+		return bt.trace;
+	}
+
+	// check for point special case
+	if (VectorCompare (mins, vec3_origin) && VectorCompare (maxs, vec3_origin))
+	{
+		bt.ispoint = true;
+		VectorClear (bt.extents);
+	}
+	else
+	{
+		bt.ispoint = false;
+		for (i=0 ; i<3 ; i++)
+			bt.extents[i] = -mins[i] > maxs[i] ? -mins[i] : maxs[i];
+	}
+
+	B_RecursiveHullCheck (&bt, bsp.headnode, 0, 1, start, end);
+
+	if (bt.trace.fraction == 1)
+		VectorCopy (end, bt.trace.endpos);
+	else
+	{
+		for (i=0 ; i<3 ; i++)
+			bt.trace.endpos[i] = start[i] + bt.trace.fraction * (end[i] - start[i]);
+	}
+	return bt.trace;
+}
+
+/*
+=================
+B_CheckTrace
+
+Compares a world trace with gi.trace, which also hits entities, so only
+a world hit further away than the engine's can be checked against one.
+Returns false on a mismatch.
+=================
+*/
+static qboolean B_CheckTrace (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int contentmask, trace_t *tr)
+{
+	trace_t		etr;
+
+	etr = gi.trace (start, mins, maxs, end, NULL, contentmask);
+	bsp_checks++;
+
+	if (etr.ent == g_edicts || etr.fraction == 1)
+	{
+		if (fabs (etr.fraction - tr->fraction) < 0.001 && etr.startsolid == tr->startsolid
+			&& etr.allsolid == tr->allsolid)
+			return true;
+	}
+	else if (tr->fraction >= etr.fraction - 0.001)
+		return true;	// an entity was in front
+
+	bsp_mismatches++;
+	gi.dprintf ("bsp trace (%s) to (%s): fraction %.3f%s, engine %.3f%s\n",
+		vtos (start), vtos (end), tr->fraction, tr->startsolid ? " startsolid" : "",
+		etr.fraction, etr.startsolid ? " startsolid" : "");
+	return false;
+}
+
+static void B_TraceRay (int index, void *arg)
+{
+	bbatch_t	*batch = arg;
+	bspray_t	*ray = &batch->rays[index];
+
+	ray->trace = G_BspTrace (ray->start, NULL, NULL, ray->end, batch->contentmask);
+}
+
+/*
+=================
+G_BspTraceRays
+
+Traces a batch of lines against the world, on the workers if there are
+enough of them.  Game thread only.
+=================
+*/
+void G_BspTraceRays (bspray_t *rays, int count, int contentmask)
+{
+	bbatch_t	batch;
+	int			i;
+
+	batch.rays = rays;
+	batch.contentmask = contentmask;
+	G_RunJobs (B_TraceRay, count, &batch);
+	bsp_traces += count;
+
+	if (bsp_check->value && bsp.base)
+	{
+		for (i=0 ; i<count ; i++)
+			B_CheckTrace (rays[i].start, vec3_origin, vec3_origin, rays[i].end, contentmask, &rays[i].trace);
+	}
+}
+
+/*
+=================
+SVCmd_Bsp_f
+
+sv bsp
+sv bsp test [count]
+=================
+*/
+void SVCmd_Bsp_f (void)
+{
+	int			i, j, count, failed;
+	vec3_t		start, end, mins, maxs;
+	trace_t		tr;
+
+	if (!bsp.base)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "No world collision loaded.\n");
+		return;
+	}
+
+	if (!Q_stricmp (gi.argv(2), "test"))
+	{
+		count = atoi (gi.argv(3));
+		if (count <= 0)
+			count = 1000;
+		failed = 0;
+		for (i=0 ; i<count ; i++)
+		{
+			for (j=0 ; j<3 ; j++)
+			{
+				start[j] = bsp.mins[j] + random() * (bsp.maxs[j] - bsp.mins[j]);
+				end[j] = bsp.mins[j] + random() * (bsp.maxs[j] - bsp.mins[j]);
+			}
+			// every other one with a player sized box
+			VectorClear (mins);
+			VectorClear (maxs);
+			if (i & 1)
+			{
+				VectorSet (mins, -16, -16, -24);
+				VectorSet (maxs, 16, 16, 32);
+			}
+			tr = G_BspTrace (start, mins, maxs, end, MASK_SOLID);
+			if (!B_CheckTrace (start, mins, maxs, end, MASK_SOLID, &tr))
+				failed++;
+		}
+		gi.cprintf (NULL, PRINT_HIGH, "%i traces, %i mismatches\n", count, failed);
+		return;
+	}
+
+	gi.cprintf (NULL, PRINT_HIGH, "%s: %i planes, %i nodes, %i leafs, %i brushes, %i sides, %ik\n",
+		bsp.name, bsp.numplanes, bsp.numnodes, bsp.numleafs, bsp.numbrushes, bsp.numsides,
+		bsp.size / 1024);
+	gi.cprintf (NULL, PRINT_HIGH, "%i batched traces, %i checked, %i mismatches\n",
+		bsp_traces, bsp_checks, bsp_mismatches);
+}
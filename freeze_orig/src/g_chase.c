@@ -19,15 +19,219 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 */
 #include "g_local.h"
 
+/*freeze*/
+/*
+==============================================================================
+
+Every spectator following a player runs the same camera solve, so the
+result is kept per target for the frame and only worked out again if the
+target has moved or turned since.
+
+ChaseNext and ChasePrev walk a list of the players that can be chased,
+kept in client order and updated when a client spawns, becomes a
+spectator or leaves.
+
+==============================================================================
+*/
+
+typedef struct
+{
+	int			framenum;		// -1 for none
+	vec3_t		origin;
+	vec3_t		v_angle;
+	float		viewheight;
+	qboolean	onground;
+	vec3_t		goal;
+} chasecam_t;
+
+static chasecam_t	chasecams[MAX_CLIENTS];
+
+static int			chaseable[MAX_CLIENTS];		// edict numbers, ascending
+static int			numchaseable;
+
+/*
+=================
+G_UpdateChaseable
+
+Call after ent has spawned, changed to or from spectator or left.
+=================
+*/
+void G_UpdateChaseable (edict_t *ent)
+{
+	int		n, i, j;
+
+	n = ent - g_edicts;
+
+	for (i = 0; i < numchaseable && chaseable[i] < n; i++)
+		;
+	if (i < numchaseable && chaseable[i] == n)
+	{
+		numchaseable--;
+		for (j = i; j < numchaseable; j++)
+			chaseable[j] = chaseable[j + 1];
+	}
+
+	if (ent->inuse && ent->client && !ent->client->resp.spectator)
+	{
+		for (j = numchaseable; j > i; j--)
+			chaseable[j] = chaseable[j - 1];
+		chaseable[i] = n;
+		numchaseable++;
+	}
+}
+
+/*
+=================
+G_ResetChase
+
+After the edicts have been cleared or loaded.
+=================
+*/
+void G_ResetChase (void)
+{
+	int		i;
+
+	for (i = 0; i < MAX_CLIENTS; i++)
+		chasecams[i].framenum = -1;
+
+	numchaseable = 0;
+	for (i = 1; i <= maxclients->value; i++)
+		G_UpdateChaseable (g_edicts + i);
+}
+
+/*
+=================
+ChaseCamGoal
+
+Where the camera behind targ goes this frame.
+=================
+*/
+static void ChaseCamGoal (edict_t *targ, vec3_t goal)
+{
+	vec3_t o, ownerv;
+	vec3_t forward, right;
+	trace_t trace;
+	vec3_t angles;
+	chasecam_t *cam;
+
+	cam = &chasecams[targ - g_edicts - 1];
+	if (cam->framenum == level.framenum
+		&& VectorCompare (cam->origin, targ->s.origin)
+		&& VectorCompare (cam->v_angle, targ->client->v_angle)
+		&& cam->viewheight == targ->viewheight
+		&& cam->onground == (targ->groundentity != NULL))
+	{
+		VectorCopy (cam->goal, goal);
+		return;
+	}
+
+	VectorCopy(targ->s.origin, ownerv);
+
+	ownerv[2] += targ->viewheight;
+
+	VectorCopy(targ->client->v_angle, angles);
+	if (angles[PITCH] > 56)
+		angles[PITCH] = 56;
+	AngleVectors (angles, forward, right, NULL);
+	VectorNormalize(forward);
+	VectorMA(ownerv, -30, forward, o);
+
+	if (o[2] < targ->s.origin[2] + 20)
+		o[2] = targ->s.origin[2] + 20;
+
+	// jump animation lifts
+	if (!targ->groundentity)
+		o[2] += 16;
+
+	trace = gi.trace(ownerv, vec3_origin, vec3_origin, o, targ, MASK_SOLID);
+
+	VectorCopy(trace.endpos, goal);
+
+	VectorMA(goal, 2, forward, goal);
+
+	// pad for floors and ceilings
+	VectorCopy(goal, o);
+	o[2] += 6;
+	trace = gi.trace(goal, vec3_origin, vec3_origin, o, targ, MASK_SOLID);
+	if (trace.fraction < 1) {
+		VectorCopy(trace.endpos, goal);
+		goal[2] -= 6;
+	}
+
+	VectorCopy(goal, o);
+	o[2] -= 6;
+	trace = gi.trace(goal, vec3_origin, vec3_origin, o, targ, MASK_SOLID);
+	if (trace.fraction < 1) {
+		VectorCopy(trace.endpos, goal);
+		goal[2] += 6;
+	}
+
+	cam->framenum = level.framenum;
+	VectorCopy (targ->s.origin, cam->origin);
+	VectorCopy (targ->client->v_angle, cam->v_angle);
+	cam->viewheight = targ->viewheight;
+	cam->onground = targ->groundentity != NULL;
+	VectorCopy (goal, cam->goal);
+}
+
+/*
+=================
+ChaseStep
+
+The next player after start in the chase list, stepping by dir, that ent
+may follow.  Returns start if there is none.
+=================
+*/
+static edict_t *ChaseStep (edict_t *ent, edict_t *start, int dir)
+{
+	int		i, k, n;
+	edict_t	*e;
+
+	n = start - g_edicts;
+	for (i = 0; i < numchaseable && chaseable[i] < n; i++)
+		;
+	// i is the first entry after start going up, step back one going down
+	if (dir > 0)
+	{
+		if (i < numchaseable && chaseable[i] == n)
+			i++;
+	}
+	else
+		i--;
+
+	for (k = 0; k < numchaseable; k++, i += dir)
+	{
+		i = (i + numchaseable) % numchaseable;
+		e = g_edicts + chaseable[i];
+		if (e == start)
+			break;
+		if (!ent->client->resp.spectator && e->client->resp.team != ent->client->resp.team)
+			continue;
+		if (e->client->frozen && e != ent)
+			continue;
+		return e;
+	}
+	return start;
+}
+/*freeze*/
+
 void UpdateChaseCam(edict_t *ent)
 {
+/*freeze
 	vec3_t o, ownerv, goal;
+freeze*/
+	vec3_t goal;
+/*freeze*/
 	edict_t *targ;
+/*freeze
 	vec3_t forward, right;
 	trace_t trace;
+freeze*/
 	int i;
+/*freeze
 	vec3_t oldgoal;
 	vec3_t angles;
+freeze*/
 
 	// is our chase target gone?
 /*freeze
@@ -52,6 +256,7 @@ freeze*/
 
 	targ = ent->client->chase_target;
 
+/*freeze
 	VectorCopy(targ->s.origin, ownerv);
 	VectorCopy(ent->s.origin, oldgoal);
 
@@ -94,6 +299,9 @@ freeze*/
 		goal[2] += 6;
 	}
 
+freeze*/
+	ChaseCamGoal (targ, goal);
+
 /*freeze*/
 	if (ent->client->frozen)
 	{
@@ -134,7 +342,9 @@ freeze*/
 
 void ChaseNext(edict_t *ent)
 {
+/*freeze
 	int i;
+freeze*/
 	edict_t *e;
 
 	if (!ent->client->chase_target)
@@ -144,6 +354,7 @@ freeze*/
 		ent->client->chase_target = ent;
 /*freeze*/
 
+/*freeze
 	i = ent->client->chase_target - g_edicts;
 	do {
 		i++;
@@ -152,15 +363,12 @@ freeze*/
 		e = g_edicts + i;
 		if (!e->inuse)
 			continue;
-/*freeze*/
-		if (!ent->client->resp.spectator && e->client->resp.team != ent->client->resp.team)
-			continue;
-		if (e->client->frozen && e != ent)
-			continue;
-/*freeze*/
 		if (!e->client->resp.spectator)
 			break;
 	} while (e != ent->client->chase_target);
+freeze*/
+	e = ChaseStep (ent, ent->client->chase_target, 1);
+/*freeze*/
 
 /*freeze*/
 	if (e == ent)
@@ -176,7 +384,9 @@ freeze*/
 
 void ChasePrev(edict_t *ent)
 {
+/*freeze
 	int i;
+freeze*/
 	edict_t *e;
 
 	if (!ent->client->chase_target)
@@ -186,6 +396,7 @@ freeze*/
 		ent->client->chase_target = ent;
 /*freeze*/
 
+/*freeze
 	i = ent->client->chase_target - g_edicts;
 	do {
 		i--;
@@ -194,15 +405,12 @@ freeze*/
 		e = g_edicts + i;
 		if (!e->inuse)
 			continue;
-/*freeze*/
-		if (!ent->client->resp.spectator && e->client->resp.team != ent->client->resp.team)
-			continue;
-		if (e->client->frozen && e != ent)
-			continue;
-/*freeze*/
 		if (!e->client->resp.spectator)
 			break;
 	} while (e != ent->client->chase_target);
+freeze*/
+	e = ChaseStep (ent, ent->client->chase_target, -1);
+/*freeze*/
 
 /*freeze*/
 	if (e == ent)
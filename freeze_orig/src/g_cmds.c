@@ -72,7 +72,7 @@ void SelectNextItem (edict_t *ent, int itflags)
 	cl = ent->client;
 
 /*freeze*/
-	if (cl->menu)
+	if (cl->menu.entries)
 	{
 		pmenu_next(ent);
 		return;
@@ -116,7 +116,7 @@ void SelectPrevItem (edict_t *ent, int itflags)
 	cl = ent->client;
 
 /*freeze*/
-	if (cl->menu)
+	if (cl->menu.entries)
 	{
 		pmenu_prev(ent);
 		return;
@@ -498,7 +498,7 @@ void Cmd_Inven_f (edict_t *ent)
 	cl->showhelp = false;
 
 /*freeze*/
-	if (cl->menu)
+	if (cl->menu.entries)
 		pmenu_close(ent);
 	else
 		pmenuBegin(ent);
@@ -530,7 +530,7 @@ void Cmd_InvUse_f (edict_t *ent)
 	gitem_t		*it;
 
 /*freeze*/
-	if (ent->client->menu)
+	if (ent->client->menu.entries)
 	{
 		pmenu_select(ent);
 		return;
@@ -712,7 +712,7 @@ void Cmd_PutAway_f (edict_t *ent)
 	ent->client->showhelp = false;
 	ent->client->showinventory = false;
 /*freeze*/
-	if (ent->client->menu)
+	if (ent->client->menu.entries)
 		pmenu_close(ent);
 /*freeze*/
 }
@@ -744,8 +744,14 @@ void Cmd_Players_f (edict_t *ent)
 {
 	int		i;
 	int		count;
+/*freeze
 	char	small[64];
 	char	large[1280];
+freeze*/
+	char	large[1280];
+	strbuf_t	sb;
+	int		mark;
+/*freeze*/
 	int		index[256];
 
 	count = 0;
@@ -760,6 +766,7 @@ void Cmd_Players_f (edict_t *ent)
 	qsort (index, count, sizeof(index[0]), PlayerSort);
 
 	// print information
+/*freeze
 	large[0] = 0;
 
 	for (i = 0 ; i < count ; i++)
@@ -773,6 +780,22 @@ void Cmd_Players_f (edict_t *ent)
 			break;
 		}
 		strcat (large, small);
+freeze*/
+	SB_Init (&sb, large, sizeof(large));
+
+	for (i = 0 ; i < count ; i++)
+	{
+		mark = sb.len;
+		SB_Printf (&sb, "%3i %s\n",
+			game.clients[index[i]].ps.stats[STAT_FRAGS],
+			game.clients[index[i]].pers.netname);
+		if (sb.len > sizeof(large) - 100 )
+		{	// can't print all of them in one packet
+			SB_Truncate (&sb, mark);
+			SB_Append (&sb, "...\n");
+			break;
+		}
+/*freeze*/
 	}
 
 	gi.cprintf (ent, PRINT_HIGH, "%s\n%i players\n", large, count);
@@ -926,6 +949,7 @@ freeze*/
 void Cmd_PlayerList_f(edict_t *ent)
 {
 	int i;
+/*freeze
 	char st[80];
 	char text[1400];
 	edict_t *e2;
@@ -937,18 +961,47 @@ void Cmd_PlayerList_f(edict_t *ent)
 			continue;
 
 		Com_sprintf(st, sizeof(st), "%02d:%02d %4d %3d %s%s\n",
+freeze*/
+	char text[1400];
+	strbuf_t sb;
+	int mark;
+	edict_t *e2;
+
+	// connect time, ping, score, name
+	SB_Init(&sb, text, sizeof(text));
+	for (i = 0, e2 = g_edicts + 1; i < maxclients->value; i++, e2++) {
+		if (!e2->inuse)
+			continue;
+
+		mark = sb.len;
+		SB_Printf(&sb, "%02d:%02d %4d %3d %s%s\n",
+/*freeze*/
+/*freeze
 			(level.framenum - e2->client->resp.enterframe) / 600,
 			((level.framenum - e2->client->resp.enterframe) % 600)/10,
+freeze*/
+			(level.framenum - e2->client->resp.enterframe) / BASEFRAMES(600),
+			((level.framenum - e2->client->resp.enterframe) % BASEFRAMES(600)) / BASEFRAMES(10),
+/*freeze*/
 			e2->client->ping,
 			e2->client->resp.score,
 			e2->client->pers.netname,
 			e2->client->resp.spectator ? " (spectator)" : "");
+/*freeze
 		if (strlen(text) + strlen(st) > sizeof(text) - 50) {
 			sprintf(text+strlen(text), "And more...\n");
 			gi.cprintf(ent, PRINT_HIGH, "%s", text);
 			return;
 		}
 		strcat(text, st);
+freeze*/
+		if (sb.len > sizeof(text) - 50) {
+			SB_Truncate(&sb, mark);
+			SB_Append(&sb, "And more...\n");
+			gi.cprintf(ent, PRINT_HIGH, "%s", text);
+			return;
+		}
+/*freeze*/
 	}
 	gi.cprintf(ent, PRINT_HIGH, "%s", text);
 }
@@ -1060,6 +1113,8 @@ freeze*/
 		cmdVote(ent);
 	else if (Q_stricmp(cmd, "ready") == 0)
 		cmdReady(ent);
+	else if (Q_stricmp(cmd, "arena") == 0)
+		cmdArena(ent);
 /*freeze*/
 	else	// anything that doesn't match a command will be a chat
 		Cmd_Say_f (ent, false, true);
@@ -135,6 +135,13 @@ void SpawnDamage (int type, vec3_t origin, vec3_t normal, int damage)
 {
 	if (damage > 255)
 		damage = 255;
+/*freeze*/
+	if (type == TE_BLOOD || type == TE_SPARKS || type == TE_BULLET_SPARKS)
+	{
+		G_EffectTemp (type, origin, normal);
+		return;
+	}
+/*freeze*/
 	gi.WriteByte (svc_temp_entity);
 	gi.WriteByte (type);
 //	gi.WriteByte (damage);
@@ -0,0 +1,361 @@
+// g_config.c -- freeze.ini, parsed once and kept until the file changes
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+freeze.ini is made of sections, each started by a [name] line and ended by
+a ### line or the next section.  Lines starting with // are comments.
+
+[motd]		up to MAX_MOTD_LINES lines for the welcome menu, blank lines
+			included.  A leading * prints the line green.
+[maplist]	one map per line: name, gravity, light level, grapple toggle.
+			Everything but the name is optional.
+[arenas]	one arena per line: map name, mins, maxs, where mins and maxs
+			are "x y z" corners of the box its spawn points are in.  A
+			map listed more than once runs that many matches at once.
+
+The file is read at every map start, normally from the copy prefetched
+during intermission, but it is only parsed again when its modification
+time or size changed.  Anything that isn't understood is reported with the
+line number and skipped.
+
+==============================================================================
+*/
+
+config_t	config;
+
+#define	SECTION_NONE	0
+#define	SECTION_MOTD	1
+#define	SECTION_MAPLIST	2
+#define	SECTION_ARENAS	3
+#define	SECTION_UNKNOWN	4
+
+static int	cfg_line;		// for diagnostics
+
+/*
+=================
+G_ConfigName
+=================
+*/
+char *G_ConfigName (void)
+{
+	static char	name[MAX_OSPATH];
+	cvar_t		*game;
+
+	game = gi.cvar ("game", "", 0);
+	if (!*game->string)
+		sprintf (name, "%s/freeze.ini", GAMEVERSION);
+	else
+		sprintf (name, "%s/freeze.ini", game->string);
+	return name;
+}
+
+static unsigned CFG_HashName (char *name)
+{
+	unsigned	hash;
+	int			c;
+
+	hash = 0;
+	while (*name)
+	{
+		c = *name++;
+		if (c >= 'A' && c <= 'Z')
+			c += 'a' - 'A';
+		hash = hash * 31 + c;
+	}
+	return hash;
+}
+
+/*
+=================
+G_FindMap
+
+Case insensitive, like the map names the engine hands out.
+=================
+*/
+mapentry_t *G_FindMap (char *name)
+{
+	int		i;
+
+	if (!config.nummaps)
+		return NULL;
+
+	for (i = config.hash[CFG_HashName (name) & (config.hashsize - 1)] ; i != -1 ; i = config.maps[i].hashnext)
+	{
+		if (!Q_stricmp (config.maps[i].name, name))
+			return &config.maps[i];
+	}
+	return NULL;
+}
+
+// cuts the next line off the text, without the line ending
+static char *CFG_NextLine (char **data)
+{
+	char	*line, *s;
+
+	line = *data;
+	if (!*line)
+		return NULL;
+
+	for (s = line ; *s && *s != '\n' ; s++)
+		;
+	if (*s)
+		*data = s + 1;
+	else
+		*data = s;
+	*s = 0;
+	if (s > line && s[-1] == '\r')
+		s[-1] = 0;
+	return line;
+}
+
+static char *CFG_Trim (char *s)
+{
+	char	*end;
+
+	while (*s == ' ' || *s == '\t')
+		s++;
+	end = s + strlen(s);
+	while (end > s && (end[-1] == ' ' || end[-1] == '\t'))
+		end--;
+	*end = 0;
+	return s;
+}
+
+static void CFG_ParseMap (char *line)
+{
+	char		*field[4];
+	char		*s;
+	int			i, numfields;
+	mapentry_t	*map;
+	unsigned	hash;
+
+	// comments may follow the map
+	s = strstr (line, "//");
+	if (s)
+		*s = 0;
+
+	numfields = 0;
+	s = line;
+	while (1)
+	{
+		if (numfields == 4)
+		{
+			gi.dprintf ("%s:%i: extra fields after \"%s\" ignored\n", G_ConfigName (), cfg_line, field[0]);
+			break;
+		}
+		field[numfields++] = s;
+		s = strchr (s, ',');
+		if (!s)
+			break;
+		*s++ = 0;
+	}
+	for (i=0 ; i<numfields ; i++)
+		field[i] = CFG_Trim (field[i]);
+	for ( ; i<4 ; i++)
+		field[i] = "";
+
+	if (!*field[0])
+	{
+		gi.dprintf ("%s:%i: missing map name\n", G_ConfigName (), cfg_line);
+		return;
+	}
+	if (G_FindMap (field[0]))
+	{
+		gi.dprintf ("%s:%i: %s is already in the map list\n", G_ConfigName (), cfg_line, field[0]);
+		return;
+	}
+
+	map = &config.maps[config.nummaps];
+	memset (map, 0, sizeof(*map));
+	map->name = field[0];
+	if (*field[1])
+		map->gravity = field[1];
+	map->light = atoi (field[2]);
+	if (map->light < 0 || map->light > 10)
+	{
+		gi.dprintf ("%s:%i: light level %s is not 0 - 10\n", G_ConfigName (), cfg_line, field[2]);
+		map->light = 0;
+	}
+	map->hook = atoi (field[3]) != 0;
+
+	// the hash table was sized for every line of the file, so it never fills
+	hash = CFG_HashName (map->name) & (config.hashsize - 1);
+	map->hashnext = config.hash[hash];
+	config.hash[hash] = config.nummaps;
+	config.nummaps++;
+}
+
+static void CFG_ParseArena (char *line)
+{
+	char			*field[3];
+	char			*s;
+	int				i, numfields;
+	arenaentry_t	*arena;
+
+	s = strstr (line, "//");
+	if (s)
+		*s = 0;
+
+	numfields = 0;
+	for (s = line ; s && numfields < 3 ; numfields++)
+	{
+		field[numfields] = s;
+		s = strchr (s, ',');
+		if (s)
+			*s++ = 0;
+	}
+	if (s || numfields < 3)
+	{
+		gi.dprintf ("%s:%i: arena needs a map name, mins and maxs\n", G_ConfigName (), cfg_line);
+		return;
+	}
+	for (i=0 ; i<numfields ; i++)
+		field[i] = CFG_Trim (field[i]);
+
+	arena = &config.arenas[config.numarenas];
+	arena->map = field[0];
+	if (sscanf (field[1], "%f %f %f", &arena->mins[0], &arena->mins[1], &arena->mins[2]) != 3
+		|| sscanf (field[2], "%f %f %f", &arena->maxs[0], &arena->maxs[1], &arena->maxs[2]) != 3)
+	{
+		gi.dprintf ("%s:%i: arena corners must be \"x y z\"\n", G_ConfigName (), cfg_line);
+		return;
+	}
+	config.numarenas++;
+}
+
+static void CFG_Parse (void)
+{
+	char	*data, *line, *s, *end;
+	int		section, numlines, i;
+
+	// one map per line at most
+	numlines = 1;
+	for (s = config.text ; *s ; s++)
+		if (*s == '\n')
+			numlines++;
+	for (config.hashsize = 16 ; config.hashsize < numlines * 2 ; config.hashsize <<= 1)
+		;
+	config.maps = malloc (numlines * sizeof(mapentry_t));
+	config.hash = malloc (config.hashsize * sizeof(int));
+	config.arenas = malloc (numlines * sizeof(arenaentry_t));
+	if (!config.maps || !config.hash || !config.arenas)
+		gi.error ("CFG_Parse: out of memory");
+	for (i=0 ; i<config.hashsize ; i++)
+		config.hash[i] = -1;
+
+	section = SECTION_NONE;
+	data = config.text;
+	for (cfg_line = 1 ; (line = CFG_NextLine (&data)) != NULL ; cfg_line++)
+	{
+		s = line;
+		while (*s == ' ' || *s == '\t')
+			s++;
+		if (s[0] == '/' && s[1] == '/')
+			continue;
+		if (!strncmp (s, "###", 3))
+		{
+			section = SECTION_NONE;
+			continue;
+		}
+		if (*s == '[')
+		{
+			end = strchr (s, ']');
+			if (end)
+				*end = 0;
+			s++;
+			if (!Q_stricmp (s, "motd"))
+				section = SECTION_MOTD;
+			else if (!Q_stricmp (s, "maplist"))
+				section = SECTION_MAPLIST;
+			else if (!Q_stricmp (s, "arenas"))
+				section = SECTION_ARENAS;
+			else
+			{
+				gi.dprintf ("%s:%i: unknown section [%s]\n", G_ConfigName (), cfg_line, s);
+				section = SECTION_UNKNOWN;
+			}
+			continue;
+		}
+
+		switch (section)
+		{
+		case SECTION_MOTD:
+			if (config.nummotd == MAX_MOTD_LINES)
+			{
+				if (*s)
+					gi.dprintf ("%s:%i: more than %i motd lines\n", G_ConfigName (), cfg_line, MAX_MOTD_LINES);
+				break;
+			}
+			config.motd[config.nummotd++] = *line ? line : NULL;
+			break;
+
+		case SECTION_MAPLIST:
+			if (*s)
+				CFG_ParseMap (s);
+			break;
+
+		case SECTION_ARENAS:
+			if (*s)
+				CFG_ParseArena (s);
+			break;
+
+		case SECTION_NONE:
+			if (*s)
+				gi.dprintf ("%s:%i: \"%s\" is outside of any section\n", G_ConfigName (), cfg_line, s);
+			break;
+		}
+	}
+}
+
+/*
+=================
+G_FreeConfig
+=================
+*/
+void G_FreeConfig (void)
+{
+	G_FreeFile (config.text);
+	if (config.maps)
+		free (config.maps);
+	if (config.hash)
+		free (config.hash);
+	if (config.arenas)
+		free (config.arenas);
+	memset (&config, 0, sizeof(config));
+}
+
+/*
+=================
+G_LoadConfig
+
+Called at every map start.  The previous config, including which maps
+the rotation has been through, stays as it is if the file didn't change.
+Returns true if the config is new.
+=================
+*/
+qboolean G_LoadConfig (void)
+{
+	char	*data;
+	int		length;
+	time_t	mtime;
+
+	data = G_LoadFile (G_ConfigName (), &length, &mtime);
+	if (data && config.text && length == config.length && mtime == config.mtime)
+	{
+		G_FreeFile (data);
+		return false;
+	}
+
+	G_FreeConfig ();
+	if (!data)
+		return true;
+
+	config.text = data;
+	config.length = length;
+	config.mtime = mtime;
+	CFG_Parse ();
+	return true;
+}
@@ -0,0 +1,163 @@
+// g_cstring.c -- configstring changes, deduplicated and sent once a frame
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+Every gi.configstring the engine gets while the level is running goes to
+every client as a reliable message, whether or not the string changed.
+The round code sets the team scores and every player's skin over and over
+with the same values, and a whole team changing colour at once sends a
+skin for each of them in the same frame.
+
+gi.configstring is wrapped so a change is only written down.  At the end
+of the frame G_FlushConfigstrings sends the last value each index was set
+to, and only if it differs from what the engine already has.  No more than
+cs_budget strings are sent a frame, the rest wait their turn for the next,
+so a mass skin change goes out over a few frames.  cs_budget 0 sends
+everything at once.
+
+While a level is loading nothing is broadcast, the engine just keeps the
+strings for the gamestate, so they go straight through until the first
+frame has run.  Strings too long for the table, the status bar, also go
+straight through, and the indices they spill into are forgotten.
+
+==============================================================================
+*/
+
+static char		cs_sent[MAX_CONFIGSTRINGS][MAX_QPATH];	// what the engine has
+static char		cs_want[MAX_CONFIGSTRINGS][MAX_QPATH];	// what it should have
+static qboolean	cs_known[MAX_CONFIGSTRINGS];			// cs_sent is right
+static qboolean	cs_dirty[MAX_CONFIGSTRINGS];			// on cs_queue
+static int		cs_queue[MAX_CONFIGSTRINGS];			// changed indices, oldest first
+static int		cs_queued;
+static qboolean	cs_loading;
+
+static cvar_t	*cs_budget;
+
+static void		(*engine_configstring) (int num, char *string);
+
+static void C_Unqueue (int num)
+{
+	int		i, j;
+
+	if (!cs_dirty[num])
+		return;
+	cs_dirty[num] = false;
+	for (i=j=0 ; i<cs_queued ; i++)
+		if (cs_queue[i] != num)
+			cs_queue[j++] = cs_queue[i];
+	cs_queued = j;
+}
+
+static void C_Send (int num, char *string)
+{
+	engine_configstring (num, string);
+	strcpy (cs_sent[num], string);
+	cs_known[num] = true;
+}
+
+static void C_Configstring (int num, char *string)
+{
+	int		len, i;
+
+	if (num < 0 || num >= MAX_CONFIGSTRINGS)
+	{
+		engine_configstring (num, string);		// let the engine complain
+		return;
+	}
+	if (!string)
+		string = "";
+
+	len = strlen (string);
+	if (len >= MAX_QPATH)
+	{
+		C_Unqueue (num);
+		engine_configstring (num, string);
+		for (i=num ; i<MAX_CONFIGSTRINGS && i<=num + len/MAX_QPATH ; i++)
+			cs_known[i] = false;
+		return;
+	}
+
+	if (cs_loading)
+	{
+		C_Unqueue (num);
+		C_Send (num, string);
+		return;
+	}
+
+	strcpy (cs_want[num], string);
+	if (!cs_dirty[num])
+	{
+		cs_dirty[num] = true;
+		cs_queue[cs_queued++] = num;
+	}
+}
+
+/*
+=================
+G_InitConfigstrings
+
+Called from InitGame.
+=================
+*/
+void G_InitConfigstrings (void)
+{
+	cs_budget = gi.cvar ("cs_budget", "16", 0);
+
+	if (gi.configstring == C_Configstring)
+		return;
+	engine_configstring = gi.configstring;
+	gi.configstring = C_Configstring;
+}
+
+/*
+=================
+G_ResetConfigstrings
+
+Called from SpawnEntities and ReadLevel, the engine has just cleared its
+own table and nothing from the last level may be sent or held back.
+=================
+*/
+void G_ResetConfigstrings (void)
+{
+	memset (cs_known, 0, sizeof(cs_known));
+	memset (cs_dirty, 0, sizeof(cs_dirty));
+	cs_queued = 0;
+	cs_loading = true;
+}
+
+/*
+=================
+G_FlushConfigstrings
+
+Called at the end of every frame.
+=================
+*/
+void G_FlushConfigstrings (void)
+{
+	int		i, j, num, sends;
+
+	cs_loading = false;
+
+	sends = 0;
+	for (i=j=0 ; i<cs_queued ; i++)
+	{
+		num = cs_queue[i];
+		if (cs_known[num] && !strcmp (cs_sent[num], cs_want[num]))
+		{
+			cs_dirty[num] = false;
+			continue;
+		}
+		if (cs_budget->value > 0 && sends >= cs_budget->value)
+		{
+			cs_queue[j++] = num;
+			continue;
+		}
+		C_Send (num, cs_want[num]);
+		cs_dirty[num] = false;
+		sends++;
+	}
+	cs_queued = j;
+}
@@ -0,0 +1,257 @@
+// g_effect.c -- cosmetic effects, sent only where the connection has room
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+A gib, a splash of blood or a spark costs every client that can see it
+the same bytes, whatever their rate.  In a big fight that is enough to
+make a modem player's packets go over their rate and the server starts
+holding frames back from them.
+
+Each client's declared rate is kept from their userinfo, along with a
+rough count of the bytes they are being sent: the frame itself and the
+moving entities in their view, which is looked at for a few clients
+every frame, plus every cosmetic effect they were given.  What the rate
+lets through every frame comes off that again.
+
+Temp entities that only look nice go through G_EffectTemp.  If every
+client that can see the spot has room, or is within effect_near of it,
+it is multicast as before, otherwise it is unicast to the ones that do.
+An entity goes to everybody who can see it, so G_EffectEntity just says
+whether all of them have room for one, and the gib or flash is left out
+when they don't.  Anything that tells a player something about the game
+stays on gi.multicast.
+
+effect_backlog is how many seconds of their rate a client may be behind
+and still get cosmetic effects, 0 sends everything to everybody.
+
+==============================================================================
+*/
+
+#define	FX_FRAME		24		// frame header and player state, every packet
+#define	FX_ENTITY		12		// a moving entity's delta
+#define	FX_TEMP			12		// a temp entity with a direction
+#define	FX_LOOK			5		// BASETIME frames between looks at a client's view
+
+typedef struct
+{
+	int		rate;			// bytes a second, from userinfo
+	float	load;			// bytes a frame the view is costing
+	float	backlog;		// bytes not through the connection yet
+	int		framenum;		// backlog is up to date for this frame
+} fxclient_t;
+
+static fxclient_t	fx_clients[MAX_CLIENTS];
+static int			fx_next;		// the next client to look at
+
+static cvar_t	*effect_backlog;
+static cvar_t	*effect_near;
+
+/*
+=================
+G_InitEffects
+
+Called from InitGame.
+=================
+*/
+void G_InitEffects (void)
+{
+	effect_backlog = gi.cvar ("effect_backlog", "0.1", 0);
+	effect_near = gi.cvar ("effect_near", "256", 0);
+}
+
+/*
+=================
+G_EffectRate
+
+Called from ClientUserinfoChanged, the same limits the server puts on it.
+=================
+*/
+void G_EffectRate (edict_t *ent, char *userinfo)
+{
+	fxclient_t	*fx;
+	char		*s;
+
+	fx = &fx_clients[ent - g_edicts - 1];
+	s = Info_ValueForKey (userinfo, "rate");
+	if (*s)
+	{
+		fx->rate = atoi (s);
+		if (fx->rate < 100)
+			fx->rate = 100;
+		else if (fx->rate > 15000)
+			fx->rate = 15000;
+	}
+	else
+		fx->rate = 5000;
+	fx->backlog = 0;
+	fx->framenum = level.framenum;
+}
+
+static void FX_Catchup (fxclient_t *fx)
+{
+	int		frames;
+
+	frames = level.framenum - fx->framenum;
+	fx->framenum = level.framenum;
+	if (frames <= 0)
+		return;
+	fx->backlog += frames * (fx->load - fx->rate * FRAMETIME);
+	if (fx->backlog < 0)
+		fx->backlog = 0;
+	else if (fx->backlog > fx->rate)
+		fx->backlog = fx->rate;
+}
+
+static float FX_Load (edict_t *ent)
+{
+	edict_t	*e;
+	int		count;
+
+	count = 0;
+	for (e = g_edicts + 1 ; e < &g_edicts[globals.num_edicts] ; e++)
+	{
+		if (!e->inuse || e == ent || (e->svflags & SVF_NOCLIENT))
+			continue;
+		if (!e->client && !e->s.effects && VectorCompare (e->velocity, vec3_origin))
+			continue;
+		if (gi.inPVS (ent->s.origin, e->s.origin))
+			count++;
+	}
+	return FX_FRAME + FX_ENTITY * count;
+}
+
+/*
+=================
+G_EffectFrame
+
+Called every frame, looks at what a few of the clients can see.
+=================
+*/
+void G_EffectFrame (void)
+{
+	edict_t	*ent;
+	int		i, looks;
+
+	if (effect_backlog->value <= 0)
+		return;
+
+	looks = game.maxclients / BASEFRAMES(FX_LOOK) + 1;
+	for (i = 0 ; i < looks ; i++)
+	{
+		fx_next = (fx_next + 1) % game.maxclients;
+		ent = g_edicts + 1 + fx_next;
+		if (!ent->inuse || !ent->client->pers.connected)
+			continue;
+		FX_Catchup (&fx_clients[fx_next]);
+		fx_clients[fx_next].load = FX_Load (ent);
+	}
+}
+
+/*
+=================
+FX_Viewers
+
+The clients that can see origin, and how many of them have room for
+bytes more.  Those are charged for it.
+=================
+*/
+static int FX_Viewers (vec3_t origin, int bytes, edict_t **room, int *viewers)
+{
+	edict_t		*ent;
+	fxclient_t	*fx;
+	vec3_t		v;
+	int			i, n;
+
+	n = *viewers = 0;
+	for (i = 0 ; i < game.maxclients ; i++)
+	{
+		ent = g_edicts + 1 + i;
+		if (!ent->inuse || !ent->client->pers.connected)
+			continue;
+		if (!gi.inPVS (ent->s.origin, origin))
+			continue;
+		(*viewers)++;
+
+		fx = &fx_clients[i];
+		FX_Catchup (fx);
+		VectorSubtract (ent->s.origin, origin, v);
+		if (fx->backlog + bytes > fx->rate * effect_backlog->value
+			&& VectorLength (v) > effect_near->value)
+			continue;
+		fx->backlog += bytes;
+		room[n++] = ent;
+	}
+	return n;
+}
+
+/*
+=================
+G_EffectTemp
+
+A temp entity with a position and a direction, for those with room.
+Calls the engine, so only from the game thread.
+=================
+*/
+void G_EffectTemp (int type, vec3_t origin, vec3_t dir)
+{
+	edict_t	*room[MAX_CLIENTS];
+	int		i, n, viewers;
+
+	if (effect_backlog->value > 0)
+	{
+		n = FX_Viewers (origin, FX_TEMP, room, &viewers);
+		if (n < viewers)
+		{
+			for (i = 0 ; i < n ; i++)
+			{
+				gi.WriteByte (svc_temp_entity);
+				gi.WriteByte (type);
+				gi.WritePosition (origin);
+				gi.WriteDir (dir);
+				gi.unicast (room[i], false);
+			}
+			return;
+		}
+	}
+
+	gi.WriteByte (svc_temp_entity);
+	gi.WriteByte (type);
+	gi.WritePosition (origin);
+	gi.WriteDir (dir);
+	gi.multicast (origin, MULTICAST_PVS);
+}
+
+/*
+=================
+G_EffectEntity
+
+Whether everybody who can see origin has room for an entity change
+costing bytes.  If they do they are charged for it.
+
+The engine sends an entity to everyone who can see it or to nobody, so
+one viewer without room takes the gib or flash away from all of them.
+That is meant: the other viewers lose a little decoration so the one on
+a slow connection stays under their rate.  Calls the engine, so only
+from the game thread.
+=================
+*/
+qboolean G_EffectEntity (vec3_t origin, int bytes)
+{
+	edict_t	*room[MAX_CLIENTS];
+	int		i, n, viewers;
+
+	if (effect_backlog->value <= 0)
+		return true;
+
+	n = FX_Viewers (origin, bytes, room, &viewers);
+	if (n == viewers)
+		return true;
+
+	// nothing goes out, so nobody pays for it
+	for (i = 0 ; i < n ; i++)
+		fx_clients[room[i] - g_edicts - 1].backlog -= bytes;
+	return false;
+}
@@ -0,0 +1,198 @@
+// g_hot.c -- copies of the edict fields that whole-array scans look at
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+An edict is well over a kilobyte, so a loop over g_edicts that only looks
+at inuse or the bounding box misses the cache on every entity.  The fields
+those loops need are copied into g_hot, one small array per field, and the
+loops only go to the edict itself for the entities they are after.
+
+inuse and freetime are only changed by G_InitEdict, G_FreeEdict and the
+client connect code, which keep the copies exact.  The bounding box is
+only changed by linking, so gi.linkentity and gi.unlinkentity are wrapped
+to copy it.  classname is copied at those points too, and again every
+frame after the entity has run, so a classname changed without a link is
+seen from the next frame on.  G_Find only trusts the copy for linked
+entities; one that was just spawned and named, and not linked yet, is
+looked at in the edict itself.
+
+Every entity whose groundentity is set to something other than the world
+is also put on that entity's list of riders with G_AddRider, so a pusher
+can find what is standing on it without looking at every edict.  Nothing
+is taken off when groundentity changes again, G_Riders drops whatever is
+no longer standing there when it walks the list.
+
+==============================================================================
+*/
+
+edicthot_t	g_hot;
+
+static void	(*engine_linkentity) (edict_t *ent);
+static void	(*engine_unlinkentity) (edict_t *ent);
+
+/*
+=================
+G_SyncHot
+=================
+*/
+void G_SyncHot (edict_t *ent)
+{
+	int		n;
+
+	n = ent - g_edicts;
+	g_hot.serial++;
+	g_hot.inuse[n] = ent->inuse;
+	g_hot.freetime[n] = ent->freetime;
+	g_hot.linked[n] = ent->area.prev != NULL;
+	g_hot.classname[n] = ent->classname;
+	VectorCopy (ent->absmin, g_hot.absmin[n]);
+	VectorCopy (ent->absmax, g_hot.absmax[n]);
+}
+
+/*
+=================
+G_SyncAllHot
+
+After anything that rewrites g_edicts wholesale.
+=================
+*/
+void G_SyncAllHot (void)
+{
+	int		i;
+
+	memset (g_hot.riders, 0, game.maxentities * sizeof(*g_hot.riders));
+	memset (g_hot.rideson, 0, game.maxentities * sizeof(*g_hot.rideson));
+	for (i=0 ; i<game.maxentities ; i++)
+	{
+		G_SyncHot (g_edicts + i);
+		if (g_edicts[i].inuse)
+			G_AddRider (g_edicts + i);
+	}
+}
+
+/*
+=================
+G_AddRider
+
+Call after setting ent->groundentity.
+=================
+*/
+void G_AddRider (edict_t *ent)
+{
+	int		e, ground, *link;
+
+	if (!ent->groundentity || ent->groundentity == g_edicts)
+		return;
+
+	e = ent - g_edicts;
+	ground = ent->groundentity - g_edicts;
+	if (g_hot.rideson[e] == ground)
+		return;
+
+	// an entity is only on one list at a time
+	if (g_hot.rideson[e])
+	{
+		for (link = &g_hot.riders[g_hot.rideson[e]] ; *link != e ; link = &g_hot.nextrider[*link])
+			;
+		*link = g_hot.nextrider[e];
+	}
+
+	g_hot.nextrider[e] = g_hot.riders[ground];
+	g_hot.riders[ground] = e;
+	g_hot.rideson[e] = ground;
+}
+
+/*
+=================
+G_Riders
+
+The entities standing on ground, in no particular order.
+=================
+*/
+int G_Riders (edict_t *ground, int *list)
+{
+	int		*link, e, count;
+
+	count = 0;
+	link = &g_hot.riders[ground - g_edicts];
+	while (*link)
+	{
+		e = *link;
+		if (g_edicts[e].groundentity != ground)
+		{
+			*link = g_hot.nextrider[e];
+			g_hot.rideson[e] = 0;
+			continue;
+		}
+		list[count++] = e;
+		link = &g_hot.nextrider[e];
+	}
+	return count;
+}
+
+static void G_LinkEntity (edict_t *ent)
+{
+	engine_linkentity (ent);
+	G_SyncHot (ent);
+}
+
+static void G_UnlinkEntity (edict_t *ent)
+{
+	engine_unlinkentity (ent);
+	G_SyncHot (ent);
+}
+
+/*
+=================
+G_InitHot
+
+Called from InitGame, once game.maxentities is known.
+=================
+*/
+void G_InitHot (void)
+{
+	int		n;
+
+	n = game.maxentities;
+	g_hot.inuse = malloc (n * sizeof(*g_hot.inuse));
+	g_hot.linked = malloc (n * sizeof(*g_hot.linked));
+	g_hot.freetime = malloc (n * sizeof(*g_hot.freetime));
+	g_hot.classname = malloc (n * sizeof(*g_hot.classname));
+	g_hot.absmin = malloc (n * sizeof(*g_hot.absmin));
+	g_hot.absmax = malloc (n * sizeof(*g_hot.absmax));
+	g_hot.riders = malloc (n * sizeof(*g_hot.riders));
+	g_hot.nextrider = malloc (n * sizeof(*g_hot.nextrider));
+	g_hot.rideson = malloc (n * sizeof(*g_hot.rideson));
+	if (!g_hot.inuse || !g_hot.linked || !g_hot.freetime || !g_hot.classname
+		|| !g_hot.absmin || !g_hot.absmax
+		|| !g_hot.riders || !g_hot.nextrider || !g_hot.rideson)
+		gi.error ("G_InitHot: out of memory");
+
+	// everything the game links goes through here
+	if (gi.linkentity != G_LinkEntity)
+	{
+		engine_linkentity = gi.linkentity;
+		engine_unlinkentity = gi.unlinkentity;
+		gi.linkentity = G_LinkEntity;
+		gi.unlinkentity = G_UnlinkEntity;
+	}
+
+	G_SyncAllHot ();
+}
+
+void G_ShutdownHot (void)
+{
+	free (g_hot.inuse);
+	free (g_hot.linked);
+	free (g_hot.freetime);
+	free (g_hot.classname);
+	free (g_hot.absmin);
+	free (g_hot.absmax);
+	free (g_hot.riders);
+	free (g_hot.nextrider);
+	free (g_hot.rideson);
+	memset (&g_hot, 0, sizeof(g_hot));
+}
@@ -0,0 +1,539 @@
+// g_io.c -- background file i/o so the game thread never waits on the disk
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "g_local.h"
+
+/*
+==============================================================================
+
+One worker thread services a FIFO of read and write requests.
+
+Writes are copied when they are queued, so the caller can reuse its buffer
+immediately.  Reads are either prefetched, to be claimed later with
+G_LoadFile, or carry a callback.  Finished requests that are not prefetches
+are handed back to the game thread, and their callbacks run from G_RunIO,
+which G_RunFrame calls before any entity thinks.
+
+If the worker can't be started, every request is serviced inline.
+
+==============================================================================
+*/
+
+#define	IO_READ		0
+#define	IO_WRITE	1
+#define	IO_APPEND	2
+
+typedef struct ioreq_s
+{
+	struct ioreq_s	*next;			// io_queue, then io_finished
+	struct ioreq_s	*pnext;			// io_prefetched
+	int			type;
+	char		filename[MAX_OSPATH];
+	byte		*data;			// malloc'd, NUL terminated for reads
+	int			length;
+	time_t		mtime;			// modification time for reads
+	qboolean	failed;
+	qboolean	done;
+	qboolean	prefetch;
+	iodone_t	callback;
+	void		*arg;
+} ioreq_t;
+
+static gthread_t	*io_thread;
+static gmutex_t		*io_lock;
+static gcond_t		*io_work;		// signalled when a request is queued
+static gcond_t		*io_idle;		// signalled when a request finishes
+
+static ioreq_t	*io_queue, *io_queue_tail;
+static ioreq_t	*io_finished, *io_finished_tail;
+static ioreq_t	*io_prefetched;
+static ioreq_t	*io_busy;
+static qboolean	io_quit;
+
+/*
+=================
+IO_Service
+
+Does the actual disk work for one request.  Runs on the worker thread,
+so it may not touch anything but the request itself.
+=================
+*/
+static void IO_Service (ioreq_t *req)
+{
+	FILE		*f;
+	int			len;
+	struct stat	st;
+
+	if (req->type == IO_WRITE || req->type == IO_APPEND)
+	{
+		f = fopen (req->filename, req->type == IO_APPEND ? "ab" : "wb");
+		if (!f)
+		{
+			req->failed = true;
+			return;
+		}
+		if (req->length && fwrite (req->data, req->length, 1, f) != 1)
+			req->failed = true;
+		if (fclose (f))
+			req->failed = true;
+		return;
+	}
+
+	f = fopen (req->filename, "rb");
+	if (!f)
+	{
+		req->failed = true;
+		return;
+	}
+	if (!fstat (fileno (f), &st))
+		req->mtime = st.st_mtime;
+	fseek (f, 0, SEEK_END);
+	len = ftell (f);
+	fseek (f, 0, SEEK_SET);
+	if (len < 0 || !(req->data = malloc (len + 1)))
+	{
+		fclose (f);
+		req->failed = true;
+		return;
+	}
+	if (len && fread (req->data, len, 1, f) != 1)
+	{
+		free (req->data);
+		req->data = NULL;
+		req->failed = true;
+	}
+	else
+	{
+		req->data[len] = 0;
+		req->length = len;
+	}
+	fclose (f);
+}
+
+// io_lock must be held
+static void IO_Finish (ioreq_t *req)
+{
+	req->done = true;
+	if (req->prefetch)
+		return;		// waits on io_prefetched for G_LoadFile
+
+	req->next = NULL;
+	if (io_finished_tail)
+		io_finished_tail->next = req;
+	else
+		io_finished = req;
+	io_finished_tail = req;
+}
+
+static void IO_Thread (void *arg)
+{
+	ioreq_t	*req;
+
+	G_LockMutex (io_lock);
+	while (1)
+	{
+		while (!io_queue && !io_quit)
+			G_WaitCond (io_work, io_lock);
+		if (!io_queue)
+			break;		// quitting with nothing left to do
+
+		req = io_queue;
+		io_queue = req->next;
+		if (!io_queue)
+			io_queue_tail = NULL;
+		io_busy = req;
+		G_UnlockMutex (io_lock);
+
+		IO_Service (req);
+
+		G_LockMutex (io_lock);
+		io_busy = NULL;
+		IO_Finish (req);
+		G_BroadcastCond (io_idle);
+	}
+	G_UnlockMutex (io_lock);
+}
+
+static ioreq_t *IO_NewRequest (int type, char *filename)
+{
+	ioreq_t	*req;
+
+	req = malloc (sizeof(*req));
+	if (!req)
+		gi.error ("IO_NewRequest: out of memory");
+	memset (req, 0, sizeof(*req));
+	req->type = type;
+	Com_sprintf (req->filename, sizeof(req->filename), "%s", filename);
+	return req;
+}
+
+static void IO_FreeRequest (ioreq_t *req)
+{
+	if (req->data)
+		free (req->data);
+	free (req);
+}
+
+static void IO_Queue (ioreq_t *req)
+{
+	if (io_thread)
+		G_LockMutex (io_lock);
+
+	if (req->prefetch)
+	{
+		req->pnext = io_prefetched;
+		io_prefetched = req;
+	}
+
+	if (!io_thread)
+	{
+		IO_Service (req);
+		IO_Finish (req);
+		return;
+	}
+
+	req->next = NULL;
+	if (io_queue_tail)
+		io_queue_tail->next = req;
+	else
+		io_queue = req;
+	io_queue_tail = req;
+	G_SignalCond (io_work);
+	G_UnlockMutex (io_lock);
+}
+
+/*
+=================
+G_InitIO
+=================
+*/
+void G_InitIO (void)
+{
+	if (io_lock)
+		return;
+
+	io_lock = G_CreateMutex ();
+	io_work = G_CreateCond ();
+	io_idle = G_CreateCond ();
+	io_quit = false;
+	io_thread = G_CreateThread (IO_Thread, NULL);
+	if (!io_thread)
+		gi.dprintf ("Couldn't start i/o thread, file access will block\n");
+}
+
+/*
+=================
+G_ShutdownIO
+
+Finishes every outstanding write before the dll goes away.
+=================
+*/
+void G_ShutdownIO (void)
+{
+	ioreq_t	*req;
+
+	if (!io_lock)
+		return;
+
+	G_FlushIO ();
+
+	if (io_thread)
+	{
+		G_LockMutex (io_lock);
+		io_quit = true;
+		G_SignalCond (io_work);
+		G_UnlockMutex (io_lock);
+		G_JoinThread (io_thread);
+		io_thread = NULL;
+	}
+
+	while (io_prefetched)
+	{
+		req = io_prefetched;
+		io_prefetched = req->pnext;
+		IO_FreeRequest (req);
+	}
+
+	G_DestroyCond (io_idle);
+	G_DestroyCond (io_work);
+	G_DestroyMutex (io_lock);
+	io_idle = io_work = NULL;
+	io_lock = NULL;
+}
+
+/*
+=================
+G_RunIO
+
+Runs the completion callbacks of everything the worker has finished.
+Only ever called from the game thread.
+=================
+*/
+void G_RunIO (void)
+{
+	ioreq_t	*req, *next;
+
+	if (!io_lock)
+		return;
+
+	if (io_thread)
+		G_LockMutex (io_lock);
+	req = io_finished;
+	io_finished = io_finished_tail = NULL;
+	if (io_thread)
+		G_UnlockMutex (io_lock);
+
+	for ( ; req ; req = next)
+	{
+		next = req->next;
+		if (req->callback)
+			req->callback (req->filename, req->failed ? NULL : req->data, req->length, req->arg);
+		else if (req->failed)
+			gi.dprintf ("Couldn't %s %s\n", req->type == IO_READ ? "read" : "write", req->filename);
+		IO_FreeRequest (req);
+	}
+}
+
+/*
+=================
+G_FlushIO
+
+Blocks until the worker is idle, then runs the callbacks.  Used before the
+game reads back something it may still be writing, and at shutdown.
+=================
+*/
+void G_FlushIO (void)
+{
+	if (!io_lock)
+		return;
+
+	if (io_thread)
+	{
+		G_LockMutex (io_lock);
+		while (io_queue || io_busy)
+			G_WaitCond (io_idle, io_lock);
+		G_UnlockMutex (io_lock);
+	}
+
+	G_RunIO ();
+}
+
+static void IO_QueueWrite (int type, char *filename, void *data, int length, iodone_t callback, void *arg)
+{
+	ioreq_t	*req;
+
+	if (!io_lock)
+		G_InitIO ();
+
+	req = IO_NewRequest (type, filename);
+	if (length)
+	{
+		req->data = malloc (length);
+		if (!req->data)
+			gi.error ("G_WriteFile: out of memory");
+		memcpy (req->data, data, length);
+	}
+	req->length = length;
+	req->callback = callback;
+	req->arg = arg;
+	IO_Queue (req);
+}
+
+/*
+=================
+G_WriteFile
+
+The data is copied, so the caller keeps ownership of its buffer.
+=================
+*/
+void G_WriteFile (char *filename, void *data, int length, iodone_t callback, void *arg)
+{
+	IO_QueueWrite (IO_WRITE, filename, data, length, callback, arg);
+}
+
+/*
+=================
+G_AppendFile
+
+Adds to the end of the file, after any writes queued before it.
+=================
+*/
+void G_AppendFile (char *filename, void *data, int length, iodone_t callback, void *arg)
+{
+	IO_QueueWrite (IO_APPEND, filename, data, length, callback, arg);
+}
+
+/*
+=================
+G_ReadFile
+
+The callback gets NULL data if the file couldn't be read.  The data is
+only valid until the callback returns.
+=================
+*/
+void G_ReadFile (char *filename, iodone_t callback, void *arg)
+{
+	ioreq_t	*req;
+
+	if (!io_lock)
+		G_InitIO ();
+
+	req = IO_NewRequest (IO_READ, filename);
+	req->callback = callback;
+	req->arg = arg;
+	IO_Queue (req);
+}
+
+/*
+=================
+G_PrefetchFile
+
+Starts reading a file that G_LoadFile will ask for later.
+=================
+*/
+void G_PrefetchFile (char *filename)
+{
+	ioreq_t	*req, **prev;
+
+	if (!io_lock)
+		G_InitIO ();
+
+	if (io_thread)
+		G_LockMutex (io_lock);
+	for (prev = &io_prefetched ; *prev ; prev = &(*prev)->pnext)
+	{
+		req = *prev;
+		if (Q_stricmp (req->filename, filename))
+			continue;
+		if (!req->done)
+		{	// already on its way
+			if (io_thread)
+				G_UnlockMutex (io_lock);
+			return;
+		}
+		// stale copy, read it again
+		*prev = req->pnext;
+		IO_FreeRequest (req);
+		break;
+	}
+	if (io_thread)
+		G_UnlockMutex (io_lock);
+
+	req = IO_NewRequest (IO_READ, filename);
+	req->prefetch = true;
+	IO_Queue (req);
+}
+
+/*
+=================
+G_LoadFile
+
+Returns the contents of a file, NUL terminated, or NULL if it couldn't be
+read.  A prefetched copy is used if there is one, waiting for it to land
+if needed, otherwise the file is read on the spot.  Free the result with
+G_FreeFile.  The file's modification time goes in mtime if it is given.
+=================
+*/
+char *G_LoadFile (char *filename, int *length, time_t *mtime)
+{
+	ioreq_t	*req, **prev;
+	char	*data;
+
+	if (!io_lock)
+		G_InitIO ();
+
+	if (io_thread)
+		G_LockMutex (io_lock);
+	for (prev = &io_prefetched ; *prev ; prev = &(*prev)->pnext)
+	{
+		if (!Q_stricmp ((*prev)->filename, filename))
+			break;
+	}
+	req = *prev;
+	if (req)
+	{
+		while (!req->done)
+			G_WaitCond (io_idle, io_lock);
+		*prev = req->pnext;
+	}
+	if (io_thread)
+		G_UnlockMutex (io_lock);
+
+	if (!req)
+	{	// nobody asked for it in advance
+		req = IO_NewRequest (IO_READ, filename);
+		IO_Service (req);
+	}
+
+	data = (char *)req->data;
+	if (length)
+		*length = req->length;
+	if (mtime)
+		*mtime = req->mtime;
+	req->data = NULL;
+	IO_FreeRequest (req);
+	return data;
+}
+
+void G_FreeFile (char *data)
+{
+	if (data)
+		free (data);
+}
+
+/*
+==============================================================================
+
+GROWABLE WRITE BUFFERS
+
+Used to build a file in memory before handing it to G_WriteFile.
+
+==============================================================================
+*/
+
+void G_InitIOBuf (iobuf_t *buf)
+{
+	buf->data = NULL;
+	buf->cursize = 0;
+	buf->maxsize = 0;
+}
+
+void G_IOBufWrite (iobuf_t *buf, void *data, int length)
+{
+	int		newsize;
+	byte	*newdata;
+
+	if (buf->cursize + length > buf->maxsize)
+	{
+		newsize = buf->maxsize ? buf->maxsize * 2 : 16384;
+		while (newsize < buf->cursize + length)
+			newsize *= 2;
+		newdata = realloc (buf->data, newsize);
+		if (!newdata)
+			gi.error ("G_IOBufWrite: out of memory");
+		buf->data = newdata;
+		buf->maxsize = newsize;
+	}
+	memcpy (buf->data + buf->cursize, data, length);
+	buf->cursize += length;
+}
+
+void G_IOBufPrintf (iobuf_t *buf, char *fmt, ...)
+{
+	va_list		argptr;
+	char		text[1024];
+
+	va_start (argptr, fmt);
+	vsnprintf (text, sizeof(text), fmt, argptr);
+	va_end (argptr);
+	text[sizeof(text)-1] = 0;
+	G_IOBufWrite (buf, text, strlen(text));
+}
+
+void G_FreeIOBuf (iobuf_t *buf)
+{
+	if (buf->data)
+		free (buf->data);
+	G_InitIOBuf (buf);
+}
@@ -350,7 +350,11 @@ void Use_Quad (edict_t *ent, gitem_t *item)
 	}
 	else
 	{
+/*freeze
 		timeout = 300;
+freeze*/
+		timeout = BASEFRAMES(300);
+/*freeze*/
 	}
 
 	if (ent->client->quad_framenum > level.framenum)
@@ -368,10 +372,17 @@ void Use_Breather (edict_t *ent, gitem_t *item)
 	ent->client->pers.inventory[ITEM_INDEX(item)]--;
 	ValidateSelectedItem (ent);
 
+/*freeze
 	if (ent->client->breather_framenum > level.framenum)
 		ent->client->breather_framenum += 300;
 	else
 		ent->client->breather_framenum = level.framenum + 300;
+freeze*/
+	if (ent->client->breather_framenum > level.framenum)
+		ent->client->breather_framenum += BASEFRAMES(300);
+	else
+		ent->client->breather_framenum = level.framenum + BASEFRAMES(300);
+/*freeze*/
 
 //	gi.sound(ent, CHAN_ITEM, gi.soundindex("items/damage.wav"), 1, ATTN_NORM, 0);
 }
@@ -383,10 +394,17 @@ void Use_Envirosuit (edict_t *ent, gitem_t *item)
 	ent->client->pers.inventory[ITEM_INDEX(item)]--;
 	ValidateSelectedItem (ent);
 
+/*freeze
 	if (ent->client->enviro_framenum > level.framenum)
 		ent->client->enviro_framenum += 300;
 	else
 		ent->client->enviro_framenum = level.framenum + 300;
+freeze*/
+	if (ent->client->enviro_framenum > level.framenum)
+		ent->client->enviro_framenum += BASEFRAMES(300);
+	else
+		ent->client->enviro_framenum = level.framenum + BASEFRAMES(300);
+/*freeze*/
 
 //	gi.sound(ent, CHAN_ITEM, gi.soundindex("items/damage.wav"), 1, ATTN_NORM, 0);
 }
@@ -398,10 +416,17 @@ void	Use_Invulnerability (edict_t *ent, gitem_t *item)
 	ent->client->pers.inventory[ITEM_INDEX(item)]--;
 	ValidateSelectedItem (ent);
 
+/*freeze
 	if (ent->client->invincible_framenum > level.framenum)
 		ent->client->invincible_framenum += 300;
 	else
 		ent->client->invincible_framenum = level.framenum + 300;
+freeze*/
+	if (ent->client->invincible_framenum > level.framenum)
+		ent->client->invincible_framenum += BASEFRAMES(300);
+	else
+		ent->client->invincible_framenum = level.framenum + BASEFRAMES(300);
+/*freeze*/
 
 	gi.sound(ent, CHAN_ITEM, gi.soundindex("items/protect.wav"), 1, ATTN_NORM, 0);
 }
@@ -0,0 +1,161 @@
+// g_jobs.c -- a small fixed pool of worker threads for parallel loops
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+G_RunJobs calls a function once for every index from 0 to count-1, spread
+over the workers and the game thread, and returns when all of them are
+done.  Each call may only write data that belongs to its own index, and
+must not call gi.* (see g_thread.c), so the result is the same whatever
+order the calls ran in.
+
+The threads cvar sets the number of workers when the game starts, 0 picks
+one less than the number of processors, up to MAX_WORKERS.  Small loops
+aren't worth waking the workers for, they run on the game thread.
+
+==============================================================================
+*/
+
+#define	MAX_WORKERS		8
+#define	MIN_PARALLEL	8		// fewer jobs than this run on the game thread
+
+static gthread_t	*workers[MAX_WORKERS];
+static int			numworkers;
+
+static gmutex_t		*job_lock;
+static gcond_t		*job_wake;		// a new batch, or quit
+static gcond_t		*job_done;		// the last job of a batch finished
+
+static void			(*job_func) (int index, void *arg);
+static void			*job_arg;
+static int			job_count;
+static int			job_next;		// next index to hand out
+static int			job_finished;
+static int			job_batch;		// bumped for every batch
+static qboolean		job_quit;
+
+cvar_t	*threads;
+
+// runs jobs until the batch is handed out, job_lock must be held
+static void J_Work (void)
+{
+	int		index;
+
+	while (job_next < job_count)
+	{
+		index = job_next++;
+		G_UnlockMutex (job_lock);
+		job_func (index, job_arg);
+		G_LockMutex (job_lock);
+		if (++job_finished == job_count)
+			G_SignalCond (job_done);
+	}
+}
+
+static void J_Thread (void *arg)
+{
+	int		batch;
+
+	G_LockMutex (job_lock);
+	batch = job_batch;
+	while (1)
+	{
+		while (batch == job_batch && !job_quit)
+			G_WaitCond (job_wake, job_lock);
+		if (job_quit)
+			break;
+		batch = job_batch;
+		J_Work ();
+	}
+	G_UnlockMutex (job_lock);
+}
+
+/*
+=================
+G_InitJobs
+=================
+*/
+void G_InitJobs (void)
+{
+	int		n;
+
+	threads = gi.cvar ("threads", "0", CVAR_LATCH);
+
+	n = threads->value;
+	if (n <= 0)
+		n = G_NumProcessors () - 1;
+	if (n > MAX_WORKERS)
+		n = MAX_WORKERS;
+	if (n <= 0)
+		return;
+
+	job_lock = G_CreateMutex ();
+	job_wake = G_CreateCond ();
+	job_done = G_CreateCond ();
+	job_quit = false;
+
+	for (numworkers=0 ; numworkers<n ; numworkers++)
+	{
+		workers[numworkers] = G_CreateThread (J_Thread, NULL);
+		if (!workers[numworkers])
+			break;
+	}
+	if (numworkers)
+		gi.dprintf ("%i worker threads\n", numworkers);
+}
+
+void G_ShutdownJobs (void)
+{
+	int		i;
+
+	if (!job_lock)
+		return;
+
+	G_LockMutex (job_lock);
+	job_quit = true;
+	G_BroadcastCond (job_wake);
+	G_UnlockMutex (job_lock);
+
+	for (i=0 ; i<numworkers ; i++)
+		G_JoinThread (workers[i]);
+	numworkers = 0;
+
+	G_DestroyCond (job_wake);
+	G_DestroyCond (job_done);
+	G_DestroyMutex (job_lock);
+	job_lock = NULL;
+}
+
+/*
+=================
+G_RunJobs
+=================
+*/
+void G_RunJobs (void (*func) (int index, void *arg), int count, void *arg)
+{
+	int		i;
+
+	if (!numworkers || count < MIN_PARALLEL)
+	{
+		for (i=0 ; i<count ; i++)
+			func (i, arg);
+		return;
+	}
+
+	G_LockMutex (job_lock);
+	job_func = func;
+	job_arg = arg;
+	job_count = count;
+	job_next = 0;
+	job_finished = 0;
+	job_batch++;
+	G_BroadcastCond (job_wake);
+
+	// the game thread works too
+	J_Work ();
+	while (job_finished < job_count)
+		G_WaitCond (job_done, job_lock);
+	G_UnlockMutex (job_lock);
+}
@@ -0,0 +1,366 @@
+// g_journal.c -- binary match event journal for offline analytics
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "g_local.h"
+
+/*
+==============================================================================
+
+Events are fixed size records stored straight into a ring on the game thread,
+no formatting and no allocation.  At the end of every frame the new records
+are published to a writer thread, which appends them to the current journal
+file and starts the next one when it grows past journal_size megabytes.
+Files are reused round robin, journal00.fjl through journal_files - 1.
+
+If the writer falls behind far enough to fill the ring, new events are
+dropped and a JE_DROPPED record notes how many.
+
+The exporter in tools/jexport.c turns the files into CSV or JSON Lines.
+
+==============================================================================
+*/
+
+#define	JOURNAL_RING	8192		// events, must be a power of two
+#define	JOURNAL_MASK	(JOURNAL_RING - 1)
+
+static jevent_t		j_ring[JOURNAL_RING];
+static unsigned		j_head;			// next free slot, game thread only
+static unsigned		j_published;	// written by the game thread under j_lock
+static unsigned		j_tail;			// written by the writer under j_lock
+static unsigned		j_tail_seen;	// copy of j_tail taken at the last publish
+static int			j_dropped;
+static int			j_wallclock;
+static qboolean		j_failed;		// writer couldn't open a file, under j_lock
+static char			j_names[MAX_CLIENTS][16];	// last JE_NAME for each client
+
+static gthread_t	*j_thread;
+static gmutex_t		*j_lock;
+static gcond_t		*j_wake;
+static qboolean		j_quit;
+
+// writer thread only
+static char		j_base[MAX_OSPATH];
+static int		j_maxsize;
+static int		j_numfiles;
+static int		j_index;
+static int		j_filesize;
+
+cvar_t	*journal;
+cvar_t	*journal_size;
+cvar_t	*journal_files;
+
+/*
+=================
+J_FirstIndex
+
+Continue after the most recently written journal file, so a restart
+doesn't overwrite the newest data.
+=================
+*/
+static int J_FirstIndex (void)
+{
+	char		name[MAX_OSPATH];
+	struct stat	st;
+	int			i, best;
+	time_t		newest;
+
+	best = -1;
+	newest = 0;
+	for (i=0 ; i<j_numfiles ; i++)
+	{
+		Com_sprintf (name, sizeof(name), "%s%02d.fjl", j_base, i);
+		if (stat (name, &st))
+			continue;
+		if (best == -1 || st.st_mtime > newest)
+		{
+			best = i;
+			newest = st.st_mtime;
+		}
+	}
+	return best;
+}
+
+static FILE *J_OpenNext (void)
+{
+	char		name[MAX_OSPATH];
+	jheader_t	header;
+	FILE		*f;
+
+	j_index = (j_index + 1) % j_numfiles;
+	Com_sprintf (name, sizeof(name), "%s%02d.fjl", j_base, j_index);
+	f = fopen (name, "wb");
+	if (!f)
+		return NULL;
+
+	header.magic = JOURNAL_MAGIC;
+	header.version = JOURNAL_VERSION;
+	header.eventsize = sizeof(jevent_t);
+	header.created = (int)time (NULL);
+	fwrite (&header, sizeof(header), 1, f);
+	j_filesize = sizeof(header);
+	return f;
+}
+
+static void J_Thread (void *arg)
+{
+	FILE		*f;
+	unsigned	start, end, n;
+
+	f = NULL;
+	j_index = J_FirstIndex ();
+
+	G_LockMutex (j_lock);
+	while (1)
+	{
+		while (j_tail == j_published && !j_quit)
+			G_WaitCond (j_wake, j_lock);
+		if (j_tail == j_published)
+			break;		// quitting and everything is on disk
+		start = j_tail;
+		end = j_published;
+		G_UnlockMutex (j_lock);
+
+		while (start != end)
+		{
+			if (!f || j_filesize >= j_maxsize)
+			{
+				if (f)
+					fclose (f);
+				f = J_OpenNext ();
+				if (!f)
+				{
+					G_LockMutex (j_lock);
+					j_failed = true;
+					G_UnlockMutex (j_lock);
+				}
+			}
+
+			// don't write past the end of the ring in one go
+			n = end - start;
+			if (n > JOURNAL_RING - (start & JOURNAL_MASK))
+				n = JOURNAL_RING - (start & JOURNAL_MASK);
+			if (f)
+			{
+				fwrite (&j_ring[start & JOURNAL_MASK], sizeof(jevent_t), n, f);
+				j_filesize += n * sizeof(jevent_t);
+			}
+			start += n;
+		}
+		if (f)
+			fflush (f);
+
+		G_LockMutex (j_lock);
+		j_tail = end;
+	}
+	G_UnlockMutex (j_lock);
+
+	if (f)
+		fclose (f);
+}
+
+/*
+=================
+G_InitJournal
+=================
+*/
+void G_InitJournal (void)
+{
+	cvar_t	*game;
+
+	journal = gi.cvar ("journal", "0", CVAR_LATCH);
+	journal_size = gi.cvar ("journal_size", "8", CVAR_LATCH);
+	journal_files = gi.cvar ("journal_files", "8", CVAR_LATCH);
+
+	if (!journal->value || j_thread)
+		return;
+
+	game = gi.cvar ("game", "", 0);
+	if (!*game->string)
+		Com_sprintf (j_base, sizeof(j_base), "%s/journal", GAMEVERSION);
+	else
+		Com_sprintf (j_base, sizeof(j_base), "%s/journal", game->string);
+
+	// the writer adds "NN.fjl" and has nobody to complain to if that doesn't fit
+	if (strlen (j_base) + 7 > sizeof(j_base))
+	{
+		gi.dprintf ("The game directory is too long for journal names, journal disabled\n");
+		return;
+	}
+
+	j_maxsize = journal_size->value * 1024 * 1024;
+	if (j_maxsize < 65536)
+		j_maxsize = 65536;
+	j_numfiles = journal_files->value;
+	if (j_numfiles < 1)
+		j_numfiles = 1;
+	else if (j_numfiles > 100)
+		j_numfiles = 100;
+
+	j_head = j_published = j_tail = j_tail_seen = 0;
+	j_dropped = 0;
+	j_failed = false;
+	memset (j_names, 0, sizeof(j_names));
+	j_quit = false;
+	j_wallclock = (int)time (NULL);
+
+	j_lock = G_CreateMutex ();
+	j_wake = G_CreateCond ();
+	j_thread = G_CreateThread (J_Thread, NULL);
+	if (!j_thread)
+	{
+		gi.dprintf ("Couldn't start the journal thread, journal disabled\n");
+		G_DestroyCond (j_wake);
+		G_DestroyMutex (j_lock);
+		j_wake = NULL;
+		j_lock = NULL;
+	}
+}
+
+/*
+=================
+G_ShutdownJournal
+
+Everything that was logged makes it to disk.
+=================
+*/
+void G_ShutdownJournal (void)
+{
+	if (!j_thread)
+		return;
+
+	G_JournalFrame ();
+
+	G_LockMutex (j_lock);
+	j_quit = true;
+	G_SignalCond (j_wake);
+	G_UnlockMutex (j_lock);
+	G_JoinThread (j_thread);
+	j_thread = NULL;
+
+	G_DestroyCond (j_wake);
+	G_DestroyMutex (j_lock);
+	j_wake = NULL;
+	j_lock = NULL;
+}
+
+static jevent_t *J_Alloc (int type, edict_t *actor, edict_t *target, int team, int arg, int arg2)
+{
+	jevent_t	*e;
+
+	if (j_head - j_tail_seen >= JOURNAL_RING)
+	{
+		j_dropped++;
+		return NULL;
+	}
+	e = &j_ring[j_head & JOURNAL_MASK];
+	j_head++;
+
+	e->time = (int)(level.time * 1000);
+	e->wallclock = j_wallclock;
+	e->type = type;
+	e->actor = (actor && actor->client) ? actor - g_edicts - 1 : JE_NOCLIENT;
+	e->target = (target && target->client) ? target - g_edicts - 1 : JE_NOCLIENT;
+	e->team = team;
+	e->arg = arg;
+	e->arg2 = arg2;
+	return e;
+}
+
+/*
+=================
+G_JournalEvent
+
+Cheap enough to call from anywhere on the game thread.
+=================
+*/
+void G_JournalEvent (int type, edict_t *actor, edict_t *target, int team, int arg, int arg2)
+{
+	jevent_t	*e;
+
+	if (!j_thread)
+		return;
+	if (type == JE_LEAVE && actor && actor->client)
+		j_names[actor - g_edicts - 1][0] = 0;
+	e = J_Alloc (type, actor, target, team, arg, arg2);
+	if (e)
+		memset (e->text, 0, sizeof(e->text));
+}
+
+/*
+=================
+G_JournalName
+
+A JE_NAME when the client's name isn't the one last logged for them.
+ClientUserinfoChanged runs on every respawn, not just on a rename.
+=================
+*/
+void G_JournalName (edict_t *ent)
+{
+	char	*last;
+
+	if (!j_thread)
+		return;
+	last = j_names[ent - g_edicts - 1];
+	if (!strcmp (last, ent->client->pers.netname))
+		return;
+	Com_sprintf (last, sizeof(j_names[0]), "%s", ent->client->pers.netname);
+	G_JournalText (JE_NAME, ent, ent->client->resp.team, 0, ent->client->pers.netname);
+}
+
+void G_JournalText (int type, edict_t *actor, int team, int arg, char *text)
+{
+	jevent_t	*e;
+	int			len;
+
+	if (!j_thread)
+		return;
+	e = J_Alloc (type, actor, NULL, team, arg, 0);
+	if (!e)
+		return;
+
+	// the field is fixed width, a text that fills it has no terminator
+	len = strlen (text);
+	if (len > sizeof(e->text))
+		len = sizeof(e->text);
+	memset (e->text, 0, sizeof(e->text));
+	memcpy (e->text, text, len);
+}
+
+/*
+=================
+G_JournalFrame
+
+Hands this frame's events to the writer.  Called at the end of G_RunFrame.
+=================
+*/
+void G_JournalFrame (void)
+{
+	qboolean	failed;
+
+	if (!j_thread)
+		return;
+
+	if (j_dropped && j_head - j_tail_seen < JOURNAL_RING)
+	{
+		G_JournalEvent (JE_DROPPED, NULL, NULL, 0, j_dropped > 32767 ? 32767 : j_dropped, 0);
+		j_dropped = 0;
+	}
+
+	j_wallclock = (int)time (NULL);
+
+	if (j_head == j_published && !j_dropped)
+		return;
+
+	G_LockMutex (j_lock);
+	j_published = j_head;
+	j_tail_seen = j_tail;
+	failed = j_failed;
+	j_failed = false;
+	G_SignalCond (j_wake);
+	G_UnlockMutex (j_lock);
+
+	// the writer only runs after a publish, so this is soon enough to hear of it
+	if (failed)
+		gi.dprintf ("Couldn't open %sNN.fjl, journal events are being discarded\n", j_base);
+}
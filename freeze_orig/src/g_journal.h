@@ -0,0 +1,49 @@
+// g_journal.h -- on-disk format of the match event journal
+//
+// Shared by the game dll and the offline exporter, so it may not depend on
+// anything else in the game.
+
+#define	JOURNAL_MAGIC	(('1'<<24)+('L'<<16)+('J'<<8)+'F')	// "FJL1" little-endian
+#define	JOURNAL_VERSION	1
+
+// a journal file is one jheader_t followed by any number of jevent_t
+typedef struct
+{
+	int		magic;
+	int		version;
+	int		eventsize;		// sizeof(jevent_t)
+	int		created;		// unix time the file was opened
+} jheader_t;
+
+// jevent_t->type
+#define	JE_DROPPED		0		// arg events were lost because the writer fell behind
+#define	JE_MATCH		1		// text = map name
+#define	JE_END			2		// team = winner, none for a stalemate, arg = score, arg2 = thaws
+#define	JE_NAME			3		// actor connected or renamed, text = netname
+#define	JE_LEAVE		4		// actor disconnected
+#define	JE_TEAM			5		// actor changed to team
+#define	JE_FRAG			6		// actor killed target, arg = MOD_*, arg2 = friendly fire
+#define	JE_FREEZE		7		// actor froze target, arg = MOD_*
+#define	JE_THAW			8		// actor thawed target
+#define	JE_MELT			9		// target's frozen_time ran out, or their team was broken
+#define	JE_BREAK		10		// every player on team is frozen
+#define	JE_HOOK			11		// actor fired the grappling hook
+#define	JE_VOTE			12		// actor voted, arg = map index, text = map name
+#define	JE_READY		13		// actor readied up, arg = 1 ready, 0 not ready
+#define	JE_NUMTYPES		14
+
+#define	JE_NOCLIENT		255		// actor or target that isn't a player
+
+// fixed size records, 32 bytes, written in host byte order
+typedef struct
+{
+	int				time;		// level time in milliseconds
+	int				wallclock;	// unix time of the frame the event happened in
+	unsigned char	type;
+	unsigned char	actor;		// client number or JE_NOCLIENT
+	unsigned char	target;
+	unsigned char	team;
+	short			arg;
+	short			arg2;
+	char			text[16];	// not NUL terminated when full
+} jevent_t;
@@ -0,0 +1,299 @@
+// g_lag.c -- lag compensation for hitscan weapons
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+Where every client was is recorded at the end of each frame.  When a
+player fires a hitscan weapon, the other players near the shot are moved
+back to where that player saw them, ping milliseconds ago, for the trace
+and put back right after it.  Damage is always done with everybody back
+in place.
+
+Players are only rewound across frames where they stayed solid, kept the
+same frozen state and didn't teleport or respawn.
+
+==============================================================================
+*/
+
+#define	LAG_HISTORY		64		// frames, power of two
+#define	LAG_MASK		(LAG_HISTORY - 1)
+
+typedef struct
+{
+	float		time;
+	vec3_t		origin;
+	vec3_t		mins, maxs;
+	qboolean	solid;
+	qboolean	frozen;
+	qboolean	teleported;		// can't interpolate from the sample before
+} lagsample_t;
+
+typedef struct
+{
+	edict_t		*ent;
+	vec3_t		origin;
+	vec3_t		mins, maxs;
+} lagsaved_t;
+
+static lagsample_t	*lag_history;		// LAG_HISTORY samples per client
+static int			lag_numclients;
+static int			lag_head;			// next sample written, same for every client
+static int			lag_count;			// samples recorded this level
+
+static lagsaved_t	lag_saved[MAX_CLIENTS];
+static int			lag_numsaved;
+
+cvar_t	*lag_compensate;
+cvar_t	*lag_max_rewind;
+
+/*
+=================
+G_InitLag
+=================
+*/
+void G_InitLag (void)
+{
+	lag_compensate = gi.cvar ("lag_compensate", "1", 0);
+	lag_max_rewind = gi.cvar ("lag_max_rewind", "200", 0);
+
+	// not TagMalloc, ReadGame frees TAG_GAME without calling InitGame again
+	lag_numclients = maxclients->value;
+	lag_history = malloc (lag_numclients * LAG_HISTORY * sizeof(lagsample_t));
+	if (!lag_history)
+		gi.error ("G_InitLag: out of memory");
+	lag_head = lag_count = 0;
+}
+
+void G_ShutdownLag (void)
+{
+	if (lag_history)
+		free (lag_history);
+	lag_history = NULL;
+	lag_head = lag_count = 0;
+}
+
+/*
+=================
+G_ClearLag
+
+Positions from the last level mean nothing on this one.
+=================
+*/
+void G_ClearLag (void)
+{
+	lag_head = lag_count = 0;
+}
+
+/*
+=================
+G_LagRecord
+
+Called at the end of every frame, once everything has moved.
+=================
+*/
+void G_LagRecord (void)
+{
+	int			i;
+	edict_t		*ent;
+	lagsample_t	*s;
+
+	if (!lag_history)
+		return;
+
+	for (i=0 ; i<lag_numclients ; i++)
+	{
+		ent = g_edicts + 1 + i;
+		s = &lag_history[i*LAG_HISTORY + lag_head];
+		s->time = level.time;
+		s->solid = ent->inuse && ent->solid != SOLID_NOT;
+		if (!s->solid)
+			continue;
+		VectorCopy (ent->s.origin, s->origin);
+		VectorCopy (ent->mins, s->mins);
+		VectorCopy (ent->maxs, s->maxs);
+		s->frozen = ent->client->frozen;
+		s->teleported = ent->s.event == EV_PLAYER_TELEPORT;
+	}
+
+	lag_head = (lag_head + 1) & LAG_MASK;
+	if (lag_count < LAG_HISTORY)
+		lag_count++;
+}
+
+/*
+=================
+G_LagPosition
+
+Where a client was at time, interpolated between frames.  Returns false
+if they can't be rewound that far, or don't need to be.
+=================
+*/
+static qboolean G_LagPosition (edict_t *ent, float time, vec3_t origin, vec3_t mins, vec3_t maxs)
+{
+	lagsample_t	*history, *s, *newer;
+	float		frac;
+	int			i;
+
+	history = &lag_history[(ent - g_edicts - 1) * LAG_HISTORY];
+	newer = NULL;
+	for (i=1 ; i<=lag_count ; i++)
+	{
+		s = &history[(lag_head - i) & LAG_MASK];
+		if (!s->solid || s->frozen != ent->client->frozen)
+			return false;
+
+		if (s->time <= time || i == lag_count)
+		{
+			if (!newer)
+				return false;		// the newest sample is where they are now
+			frac = (time - s->time) / (newer->time - s->time);
+			if (frac < 0)
+				frac = 0;			// older than the history, use the oldest
+			origin[0] = s->origin[0] + frac * (newer->origin[0] - s->origin[0]);
+			origin[1] = s->origin[1] + frac * (newer->origin[1] - s->origin[1]);
+			origin[2] = s->origin[2] + frac * (newer->origin[2] - s->origin[2]);
+			VectorCopy (s->mins, mins);
+			VectorCopy (s->maxs, maxs);
+			return true;
+		}
+
+		if (s->teleported)
+			return false;
+		newer = s;
+	}
+	return false;
+}
+
+/*
+=================
+G_LagNearSegment
+
+Could the segment from start to end pass through the box?
+=================
+*/
+static qboolean G_LagNearSegment (vec3_t start, vec3_t end, vec3_t mins, vec3_t maxs)
+{
+	int		i;
+	float	d, t0, t1, tmin, tmax;
+
+	tmin = 0;
+	tmax = 1;
+	for (i=0 ; i<3 ; i++)
+	{
+		d = end[i] - start[i];
+		if (d == 0)
+		{
+			if (start[i] < mins[i] || start[i] > maxs[i])
+				return false;
+			continue;
+		}
+		t0 = (mins[i] - start[i]) / d;
+		t1 = (maxs[i] - start[i]) / d;
+		if (t0 > t1)
+		{
+			d = t0;
+			t0 = t1;
+			t1 = d;
+		}
+		if (t0 > tmin)
+			tmin = t0;
+		if (t1 < tmax)
+			tmax = t1;
+		if (tmin > tmax)
+			return false;
+	}
+	return true;
+}
+
+static void G_LagRewind (edict_t *shooter, vec3_t start, vec3_t end)
+{
+	int			i;
+	float		rewind;
+	edict_t		*ent;
+	lagsaved_t	*saved;
+	vec3_t		origin, mins, maxs;
+	vec3_t		boxmin, boxmax;
+
+	lag_numsaved = 0;
+
+	rewind = shooter->client->ping;
+	if (rewind > lag_max_rewind->value)
+		rewind = lag_max_rewind->value;
+	if (rewind <= 0)
+		return;
+
+	for (i=0 ; i<lag_numclients ; i++)
+	{
+		ent = g_edicts + 1 + i;
+		if (ent == shooter || !ent->inuse || ent->solid == SOLID_NOT)
+			continue;
+		if (!G_LagPosition (ent, level.time - rewind * 0.001, origin, mins, maxs))
+			continue;
+		if (VectorCompare (origin, ent->s.origin) && VectorCompare (mins, ent->mins) && VectorCompare (maxs, ent->maxs))
+			continue;
+
+		// only move players the shot could possibly hit
+		VectorAdd (origin, mins, boxmin);
+		VectorAdd (origin, maxs, boxmax);
+		if (!G_LagNearSegment (start, end, boxmin, boxmax))
+			continue;
+
+		saved = &lag_saved[lag_numsaved++];
+		saved->ent = ent;
+		VectorCopy (ent->s.origin, saved->origin);
+		VectorCopy (ent->mins, saved->mins);
+		VectorCopy (ent->maxs, saved->maxs);
+
+		VectorCopy (origin, ent->s.origin);
+		VectorCopy (mins, ent->mins);
+		VectorCopy (maxs, ent->maxs);
+		gi.linkentity (ent);
+	}
+}
+
+static void G_LagRestore (void)
+{
+	int			i;
+	lagsaved_t	*saved;
+
+	for (i=0, saved=lag_saved ; i<lag_numsaved ; i++, saved++)
+	{
+		VectorCopy (saved->origin, saved->ent->s.origin);
+		VectorCopy (saved->mins, saved->ent->mins);
+		VectorCopy (saved->maxs, saved->ent->maxs);
+		gi.linkentity (saved->ent);
+	}
+	lag_numsaved = 0;
+}
+
+/*
+=================
+G_LagTrace
+
+gi.trace for a hitscan fired by shooter, against the other players as
+the shooter saw them.
+=================
+*/
+trace_t G_LagTrace (edict_t *shooter, vec3_t start, vec3_t end, edict_t *passent, int contentmask)
+{
+	trace_t		tr;
+
+	if (!lag_compensate->value || !shooter->client || !lag_count)
+		return gi.trace (start, NULL, NULL, end, passent, contentmask);
+
+	G_ProfBegin (PROF_LAG);
+	G_LagRewind (shooter, start, end);
+	G_ProfEnd (PROF_LAG);
+
+	tr = gi.trace (start, NULL, NULL, end, passent, contentmask);
+
+	if (lag_numsaved)
+	{
+		G_ProfBegin (PROF_LAG);
+		G_LagRestore ();
+		G_ProfEnd (PROF_LAG);
+	}
+	return tr;
+}
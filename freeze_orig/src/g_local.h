@@ -73,7 +73,21 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 #define FL_RESPAWN				0x80000000	// used for item respawning
 
 
+/*freeze
 #define	FRAMETIME		0.1
+freeze*/
+// the server runs sv_fps frames a second, set at startup.  FRAMETIME is
+// one server frame, but weapons, animation and other game logic still
+// step every BASETIME, on every framediv'th server frame.
+#define	BASETIME		0.1
+#define	FRAMETIME		frametime
+#define	BASEFRAMES(n)	((n) * framediv)	// BASETIME frames to server frames
+#define	BASEFRAME		(level.framenum / framediv)
+#define	ISBASEFRAME		(!(level.framenum % framediv))
+
+extern	float	frametime;
+extern	int		framediv;
+/*freeze*/
 
 // memory tags to allow dynamic memory to be cleaned up
 #define	TAG_GAME	765		// clear when unloading the dll
@@ -770,11 +784,20 @@ void player_die (edict_t *self, edict_t *inflictor, edict_t *attacker, int damag
 //
 void	ServerCommand (void);
 qboolean SV_FilterPacket (char *from);
+/*freeze*/
+void SV_InitIPFilters (void);
+void SV_ShutdownIPFilters (void);
+/*freeze*/
 
 //
 // p_view.c
 //
 void ClientEndServerFrame (edict_t *ent);
+/*freeze*/
+qboolean P_BeginViewFrame (edict_t *ent);
+void P_ViewFrame (int index, void *arg);
+void P_EndViewFrame (edict_t *ent);
+/*freeze*/
 
 //
 // p_hud.c
@@ -785,6 +808,11 @@ void G_SetSpectatorStats (edict_t *ent);
 void G_CheckChaseStats (edict_t *ent);
 void ValidateSelectedItem (edict_t *ent);
 void DeathmatchScoreboardMessage (edict_t *client, edict_t *killer);
+/*freeze*/
+void G_ResetHud (void);
+void G_HudFrame (void);
+void G_CheckHud (void);
+/*freeze*/
 
 //
 // g_pweapon.c
@@ -817,6 +845,281 @@ void UpdateChaseCam(edict_t *ent);
 void ChaseNext(edict_t *ent);
 void ChasePrev(edict_t *ent);
 void GetChaseTarget(edict_t *ent);
+/*freeze*/
+void G_UpdateChaseable (edict_t *ent);
+void G_ResetChase (void);
+/*freeze*/
+
+/*freeze*/
+//
+// g_thread.c
+//
+typedef struct gmutex_s gmutex_t;
+typedef struct gcond_s gcond_t;
+typedef struct gthread_s gthread_t;
+
+gmutex_t *G_CreateMutex (void);
+void G_DestroyMutex (gmutex_t *m);
+void G_LockMutex (gmutex_t *m);
+void G_UnlockMutex (gmutex_t *m);
+gcond_t *G_CreateCond (void);
+void G_DestroyCond (gcond_t *c);
+void G_WaitCond (gcond_t *c, gmutex_t *m);
+void G_SignalCond (gcond_t *c);
+void G_BroadcastCond (gcond_t *c);
+gthread_t *G_CreateThread (void (*func) (void *arg), void *arg);
+void G_JoinThread (gthread_t *t);
+int G_NumProcessors (void);
+
+//
+// g_io.c
+//
+// data is NULL if the request failed
+typedef void (*iodone_t) (char *filename, byte *data, int length, void *arg);
+
+typedef struct
+{
+	byte	*data;
+	int		cursize;
+	int		maxsize;
+} iobuf_t;
+
+void G_InitIO (void);
+void G_ShutdownIO (void);
+void G_RunIO (void);
+void G_FlushIO (void);
+void G_WriteFile (char *filename, void *data, int length, iodone_t callback, void *arg);
+void G_AppendFile (char *filename, void *data, int length, iodone_t callback, void *arg);
+void G_ReadFile (char *filename, iodone_t callback, void *arg);
+void G_PrefetchFile (char *filename);
+char *G_LoadFile (char *filename, int *length, time_t *mtime);
+void G_FreeFile (char *data);
+void G_InitIOBuf (iobuf_t *buf);
+void G_IOBufWrite (iobuf_t *buf, void *data, int length);
+void G_IOBufPrintf (iobuf_t *buf, char *fmt, ...);
+void G_FreeIOBuf (iobuf_t *buf);
+
+//
+// g_journal.c
+//
+#include "g_journal.h"
+
+extern	cvar_t	*journal;
+
+void G_InitJournal (void);
+void G_ShutdownJournal (void);
+void G_JournalEvent (int type, edict_t *actor, edict_t *target, int team, int arg, int arg2);
+void G_JournalText (int type, edict_t *actor, int team, int arg, char *text);
+void G_JournalName (edict_t *ent);
+void G_JournalFrame (void);
+
+//
+// g_config.c
+//
+#define	MAX_MOTD_LINES	20
+
+typedef struct
+{
+	char		*name;
+	char		*gravity;		// NULL for the default
+	int			light;			// 1 - 10, 0 for the default
+	qboolean	hook;			// grapple is disabled on this map
+	qboolean	did;			// played since the random rotation started over
+	int			hashnext;		// next map in the same hash chain, -1 ends
+	int			votes;			// players voting for this map
+	int			votenext;		// other maps with as many votes, -1 ends
+	int			voteprev;
+} mapentry_t;
+
+typedef struct
+{
+	char		*map;
+	vec3_t		mins, maxs;
+} arenaentry_t;
+
+typedef struct
+{
+	char		*text;			// the file, cut up in place
+	int			length;
+	time_t		mtime;
+
+	char		*motd[MAX_MOTD_LINES];	// NULL for blank lines
+	int			nummotd;
+
+	mapentry_t	*maps;
+	int			nummaps;
+	int			*hash;			// first map in each chain, -1 for none
+	int			hashsize;		// power of two
+
+	arenaentry_t	*arenas;	// in file order
+	int			numarenas;
+} config_t;
+
+extern	config_t	config;
+
+char *G_ConfigName (void);
+qboolean G_LoadConfig (void);
+void G_FreeConfig (void);
+mapentry_t *G_FindMap (char *name);
+
+//
+// g_prof.c
+//
+#define	PROF_FRAME		0
+#define	PROF_LAG		1
+#define	PROF_VIEWS		2
+#define	PROF_NUMSECTIONS	3
+
+extern	cvar_t	*profile;
+
+void G_InitProf (void);
+double G_ProfTime (void);
+void G_ProfBegin (int section);
+void G_ProfEnd (int section);
+void G_ProfFrame (void);
+void SVCmd_Prof_f (void);
+
+//
+// g_hot.c
+//
+typedef struct
+{
+	byte		*inuse;			// [game.maxentities]
+	byte		*linked;
+	float		*freetime;
+	char		**classname;
+	vec3_t		*absmin;		// as of the last link
+	vec3_t		*absmax;
+	int			*riders;		// first entity listed as standing on this one
+	int			*nextrider;
+	int			*rideson;		// the list this entity is in, 0 for none
+	int			serial;			// changes whenever any of the above might have
+} edicthot_t;
+
+extern	edicthot_t	g_hot;
+
+void G_InitHot (void);
+void G_ShutdownHot (void);
+void G_SyncHot (edict_t *ent);
+void G_SyncAllHot (void);
+void G_AddRider (edict_t *ent);
+int G_Riders (edict_t *ground, int *list);
+
+//
+// g_lag.c
+//
+extern	cvar_t	*lag_compensate;
+extern	cvar_t	*lag_max_rewind;
+
+void G_InitLag (void);
+void G_ShutdownLag (void);
+void G_ClearLag (void);
+void G_LagRecord (void);
+trace_t G_LagTrace (edict_t *shooter, vec3_t start, vec3_t end, edict_t *passent, int contentmask);
+
+//
+// g_jobs.c
+//
+extern	cvar_t	*threads;
+
+void G_InitJobs (void);
+void G_ShutdownJobs (void);
+void G_RunJobs (void (*func) (int index, void *arg), int count, void *arg);
+
+//
+// g_bsp.c
+//
+typedef struct
+{
+	vec3_t		start, end;
+	trace_t		trace;			// filled in by G_BspTraceRays
+} bspray_t;
+
+extern	cvar_t	*bsp_check;
+
+void G_InitBsp (void);
+void G_FreeBsp (void);
+void G_LoadBsp (char *mapname);
+qboolean G_BspLoaded (void);
+int G_BspPointContents (vec3_t p);
+trace_t G_BspTrace (vec3_t start, vec3_t mins, vec3_t maxs, vec3_t end, int contentmask);
+void G_BspTraceRays (bspray_t *rays, int count, int contentmask);
+void SVCmd_Bsp_f (void);
+
+//
+// g_vec.c
+//
+extern	cvar_t	*vec_simd;
+
+// squared distances from point to each origin, or to the nearest point of each box
+extern	void (*G_PointDistances) (vec3_t point, vec3_t *origins, int count, float *out);
+extern	void (*G_BoxDistances) (vec3_t point, vec3_t *mins, vec3_t *maxs, int count, float *out);
+extern	void (*G_DotProducts) (vec3_t v, vec3_t *vecs, int count, float *out);
+
+void G_InitVec (void);
+void SVCmd_VecBench_f (void);
+
+//
+// g_arena.c
+//
+typedef struct
+{
+	int		allocs, used;		// G_ArenaAlloc calls and bytes
+	int		blocks, bytes;		// TagMallocs behind them
+	int		strings, stringbytes;	// G_InternString calls and bytes asked for
+	int		unique;				// strings actually stored
+} arenastats_t;
+
+void G_ResetArena (void);
+void *G_ArenaAlloc (int size);
+char *G_InternString (char *s);
+void G_ArenaStats (arenastats_t *stats);
+void G_ArenaReport (void);
+
+//
+// g_mem.c
+//
+#define	MEM_OTHER		0		// anything through gi.TagMalloc
+#define	MEM_EDICTS		1
+#define	MEM_CLIENTS		2
+#define	MEM_ARENA		3
+#define	MEM_SAVE		4		// strings read from a save
+#define	MEM_NUMSUBS		5
+
+void *G_TagMalloc (int size, int tag, int sub);
+void G_InitMem (void);
+void G_MemNewLevel (void);
+void G_MemFrame (void);
+void G_MemSummary (void);
+void SVCmd_Mem_f (void);
+
+//
+// g_replay.c
+//
+void G_InitReplay (void);
+void G_ShutdownReplay (void);
+void SVCmd_Record_f (void);
+void SVCmd_Replay_f (void);
+
+//
+// g_cstring.c
+//
+void G_InitConfigstrings (void);
+void G_ResetConfigstrings (void);
+void G_FlushConfigstrings (void);
+
+//
+// g_effect.c
+//
+#define	FX_GIB		24		// a new entity
+#define	FX_FLASH	4		// a shell going off and on again
+
+void G_InitEffects (void);
+void G_EffectRate (edict_t *ent, char *userinfo);
+void G_EffectFrame (void);
+void G_EffectTemp (int type, vec3_t origin, vec3_t dir);
+qboolean G_EffectEntity (vec3_t origin, int bytes);
+/*freeze*/
 
 //============================================================================
 
@@ -884,6 +1187,7 @@ typedef struct
 	int	help;
 	int	vote;
 	int	thawed;
+	int	arena;
 /*freeze*/
 } client_respawn_t;
 
@@ -975,10 +1279,12 @@ struct gclient_s
 	qboolean	frozen;
 	edict_t*	viewed;
 	float	thaw_time;
+	edict_t*	thaw_volume;	// teammates touching it thaw us
+	qboolean	steady_shell;	// not flashing while thawed, nobody has the rate
 	float	frozen_time;
 	int	hookstate;
 	qboolean	flashlight;
-	hndnode*	menu;
+	hndnode	menu;			// open while entries is set
 	int	hooker;
 	float	moan_time;
 /*freeze*/
@@ -22,6 +22,10 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 game_locals_t	game;
 level_locals_t	level;
+/*freeze*/
+float			frametime;
+int				framediv;
+/*freeze*/
 game_import_t	gi;
 game_export_t	globals;
 spawn_temp_t	st;
@@ -95,8 +99,23 @@ void ShutdownGame (void)
 {
 	gi.dprintf ("==== ShutdownGame ====\n");
 
+/*freeze*/
+	G_ShutdownJournal ();
+	G_ShutdownReplay ();
+	G_ShutdownIO ();
+	G_FreeConfig ();
+	pmenuFree();
+	SV_ShutdownIPFilters ();
+	G_ShutdownLag ();
+	G_ShutdownHot ();
+	G_ShutdownJobs ();
+	G_FreeBsp ();
+/*freeze*/
 	gi.FreeTags (TAG_LEVEL);
 	gi.FreeTags (TAG_GAME);
+/*freeze*/
+	G_ResetArena ();
+/*freeze*/
 }
 
 
@@ -178,6 +197,15 @@ void ClientEndServerFrames (void)
 {
 	int		i;
 	edict_t	*ent;
+/*freeze*/
+	edict_t	*views[MAX_CLIENTS];
+	int		numviews;
+
+	G_ProfBegin (PROF_VIEWS);
+	numviews = 0;
+
+	G_HudFrame ();
+/*freeze*/
 
 	// calc the player views now that all pushing
 	// and damage has been added
@@ -186,9 +214,21 @@ void ClientEndServerFrames (void)
 		ent = g_edicts + 1 + i;
 		if (!ent->inuse || !ent->client)
 			continue;
+/*freeze
 		ClientEndServerFrame (ent);
+freeze*/
+		if (P_BeginViewFrame (ent))
+			views[numviews++] = ent;
 	}
 
+	// the parts that only touch each player's own state run on
+	// the workers, the rest goes back to client order
+	G_RunJobs (P_ViewFrame, numviews, views);
+	for (i=0 ; i<numviews ; i++)
+		P_EndViewFrame (views[i]);
+
+	G_ProfEnd (PROF_VIEWS);
+/*freeze*/
 }
 
 /*
@@ -232,7 +272,7 @@ void EndDMLevel (void)
 /*freeze*/
 	if (freezeMap())
 	{
-		BeginIntermission(CreateTargetChangeLevel(maplist[endMapIndex].name));
+		BeginIntermission(CreateTargetChangeLevel(config.maps[endMapIndex].name));
 		return;
 	}
 /*freeze*/
@@ -320,9 +360,8 @@ void CheckDMRules (void)
 		return;
 
 /*freeze*/
-	for (i = red; i < none; i++)
-		if (freeze[i].break_time > level.time)
-			return;
+	if (breakCheck())
+		return;
 	if (endCheck())
 	{
 		EndDMLevel();
@@ -403,6 +442,13 @@ void G_RunFrame (void)
 	level.framenum++;
 	level.time = level.framenum*FRAMETIME;
 
+/*freeze*/
+	G_ProfBegin (PROF_FRAME);
+
+	// finish any file i/o the worker completed since last frame
+	G_RunIO ();
+/*freeze*/
+
 	// choose a client for monsters to target this frame
 	AI_SetSightClient ();
 
@@ -421,7 +467,11 @@ void G_RunFrame (void)
 	ent = &g_edicts[0];
 	for (i=0 ; i<globals.num_edicts ; i++, ent++)
 	{
+/*freeze
 		if (!ent->inuse)
+freeze*/
+		if (!g_hot.inuse[i])
+/*freeze*/
 			continue;
 
 		level.current_entity = ent;
@@ -439,12 +489,21 @@ void G_RunFrame (void)
 		}
 
 		if (i > 0 && i <= maxclients->value)
+/*freeze
 		{
 			ClientBeginServerFrame (ent);
 			continue;
 		}
 
 		G_RunEntity (ent);
+freeze*/
+			ClientBeginServerFrame (ent);
+		else
+			G_RunEntity (ent);
+
+		// catch anything that changed without a link
+		G_SyncHot (ent);
+/*freeze*/
 	}
 
 	// see if it is time to end a deathmatch
@@ -455,5 +514,23 @@ void G_RunFrame (void)
 
 	// build the playerstate_t structures for all players
 	ClientEndServerFrames ();
+
+/*freeze*/
+	// remember where everybody is for lag compensated shots
+	G_LagRecord ();
+
+	// keep an eye on what each client's connection is carrying
+	G_EffectFrame ();
+
+	// hand this frame's match events to the journal writer
+	G_JournalFrame ();
+
+	// only now do this frame's configstring changes go out
+	G_FlushConfigstrings ();
+
+	G_ProfEnd (PROF_FRAME);
+	G_ProfFrame ();
+	G_MemFrame ();
+/*freeze*/
 }
 
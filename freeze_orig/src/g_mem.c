@@ -0,0 +1,269 @@
+// g_mem.c -- accounting for the memory the game gets from the engine
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+gi.TagMalloc, gi.TagFree and gi.FreeTags are wrapped so every block is
+counted by tag and by the subsystem that asked for it.  Code that knows
+what it is allocating calls G_TagMalloc with a MEM_ subsystem, anything
+else through gi.TagMalloc counts as "other".  Each block carries a small
+header with its size so TagFree can take it off again.
+
+TAG_LEVEL goes back to nothing every level.  TAG_GAME should stay the
+same size from one level to the next, so SpawnEntities checks it, and
+says which subsystem has grown if it didn't.
+
+"sv mem" prints the totals, the high water marks and the edict usage.
+
+==============================================================================
+*/
+
+#define	MEM_TAGGAME		0
+#define	MEM_TAGLEVEL	1
+#define	MEM_TAGOTHER	2
+#define	MEM_NUMTAGS		3
+
+typedef struct
+{
+	int		size;			// asked for, without the header
+	int		tag;			// MEM_TAG*
+	int		sub;			// MEM_*
+	int		pad;			// keeps the block 16 byte aligned
+} memhead_t;
+
+typedef struct
+{
+	int		bytes;
+	int		blocks;
+	int		peak;			// most bytes this level
+} memcount_t;
+
+static char	*mem_tagnames[MEM_NUMTAGS] = {"game", "level", "other"};
+static char	*mem_subnames[MEM_NUMSUBS] = {"other", "edicts", "clients", "level arena", "save strings"};
+
+static memcount_t	mem_tags[MEM_NUMTAGS];
+static memcount_t	mem_subs[MEM_NUMTAGS][MEM_NUMSUBS];
+
+static int		mem_total;				// all tags
+static int		mem_levelpeak;			// most of mem_total since the level started
+static int		mem_lastpeak;			// mem_levelpeak of the level before
+static int		mem_edictpeak;			// most globals.num_edicts this level
+static int		mem_levels;				// SpawnEntities calls
+static int		mem_lastgame[MEM_NUMSUBS];	// TAG_GAME bytes at the last SpawnEntities
+static int		mem_leaked;				// TAG_GAME growth seen over all levels
+
+static void		*(*engine_tagmalloc) (int size, int tag);
+static void		(*engine_tagfree) (void *block);
+static void		(*engine_freetags) (int tag);
+
+static int M_TagIndex (int tag)
+{
+	if (tag == TAG_GAME)
+		return MEM_TAGGAME;
+	if (tag == TAG_LEVEL)
+		return MEM_TAGLEVEL;
+	return MEM_TAGOTHER;
+}
+
+static void M_Count (memcount_t *c, int bytes, int blocks)
+{
+	c->bytes += bytes;
+	c->blocks += blocks;
+	if (c->bytes > c->peak)
+		c->peak = c->bytes;
+}
+
+/*
+=================
+G_TagMalloc
+
+gi.TagMalloc, counted against sub.
+=================
+*/
+void *G_TagMalloc (int size, int tag, int sub)
+{
+	memhead_t	*h;
+	int			t;
+
+	h = engine_tagmalloc (size + sizeof(memhead_t), tag);
+	t = M_TagIndex (tag);
+	h->size = size;
+	h->tag = t;
+	h->sub = sub;
+
+	M_Count (&mem_tags[t], size, 1);
+	M_Count (&mem_subs[t][sub], size, 1);
+	mem_total += size;
+	if (mem_total > mem_levelpeak)
+		mem_levelpeak = mem_total;
+
+	return h + 1;
+}
+
+static void *M_TagMalloc (int size, int tag)
+{
+	return G_TagMalloc (size, tag, MEM_OTHER);
+}
+
+static void M_TagFree (void *block)
+{
+	memhead_t	*h;
+
+	h = (memhead_t *)block - 1;
+	M_Count (&mem_tags[h->tag], -h->size, -1);
+	M_Count (&mem_subs[h->tag][h->sub], -h->size, -1);
+	mem_total -= h->size;
+	engine_tagfree (h);
+}
+
+static void M_FreeTags (int tag)
+{
+	int		t, i;
+
+	engine_freetags (tag);
+
+	t = M_TagIndex (tag);
+	mem_total -= mem_tags[t].bytes;
+	mem_tags[t].bytes = mem_tags[t].blocks = 0;
+	for (i=0 ; i<MEM_NUMSUBS ; i++)
+		mem_subs[t][i].bytes = mem_subs[t][i].blocks = 0;
+}
+
+/*
+=================
+G_InitMem
+
+Called from InitGame before anything is allocated.
+=================
+*/
+void G_InitMem (void)
+{
+	if (gi.TagMalloc == M_TagMalloc)
+		return;
+
+	engine_tagmalloc = gi.TagMalloc;
+	engine_tagfree = gi.TagFree;
+	engine_freetags = gi.FreeTags;
+	gi.TagMalloc = M_TagMalloc;
+	gi.TagFree = M_TagFree;
+	gi.FreeTags = M_FreeTags;
+}
+
+/*
+=================
+G_MemNewLevel
+
+Called from SpawnEntities once the old level is freed.
+=================
+*/
+void G_MemNewLevel (void)
+{
+	int		i, t, grown;
+
+	// anything in TAG_GAME that wasn't there last level is never coming back
+	if (mem_levels++)
+	{
+		grown = mem_tags[MEM_TAGGAME].bytes;
+		for (i=0 ; i<MEM_NUMSUBS ; i++)
+			grown -= mem_lastgame[i];
+		if (grown > 0)
+		{
+			mem_leaked += grown;
+			gi.dprintf ("WARNING: game memory grew %i bytes since the last level:", grown);
+			for (i=0 ; i<MEM_NUMSUBS ; i++)
+			{
+				if (mem_subs[MEM_TAGGAME][i].bytes > mem_lastgame[i])
+					gi.dprintf (" %s +%i", mem_subnames[i],
+						mem_subs[MEM_TAGGAME][i].bytes - mem_lastgame[i]);
+			}
+			gi.dprintf ("\n");
+		}
+	}
+	for (i=0 ; i<MEM_NUMSUBS ; i++)
+		mem_lastgame[i] = mem_subs[MEM_TAGGAME][i].bytes;
+
+	mem_lastpeak = mem_levelpeak;
+	mem_levelpeak = mem_total;
+	mem_edictpeak = 0;
+	for (t=0 ; t<MEM_NUMTAGS ; t++)
+	{
+		mem_tags[t].peak = mem_tags[t].bytes;
+		for (i=0 ; i<MEM_NUMSUBS ; i++)
+			mem_subs[t][i].peak = mem_subs[t][i].bytes;
+	}
+}
+
+/*
+=================
+G_MemFrame
+
+Called every frame for the edict high water mark.
+=================
+*/
+void G_MemFrame (void)
+{
+	if (globals.num_edicts > mem_edictpeak)
+		mem_edictpeak = globals.num_edicts;
+}
+
+/*
+=================
+G_MemSummary
+
+One line, for the profiler.
+=================
+*/
+void G_MemSummary (void)
+{
+	gi.cprintf (NULL, PRINT_HIGH, "memory: %ik game, %ik level, peak %ik, edicts %i peak %i of %i\n",
+		mem_tags[MEM_TAGGAME].bytes / 1024, mem_tags[MEM_TAGLEVEL].bytes / 1024,
+		mem_levelpeak / 1024, globals.num_edicts, mem_edictpeak, game.maxentities);
+}
+
+/*
+=================
+SVCmd_Mem_f
+
+sv mem
+=================
+*/
+void SVCmd_Mem_f (void)
+{
+	int				t, i;
+	memcount_t		*c;
+	arenastats_t	arena;
+
+	gi.cprintf (NULL, PRINT_HIGH, "tag   subsystem          bytes  blocks       peak\n");
+	for (t=0 ; t<MEM_NUMTAGS ; t++)
+	{
+		c = &mem_tags[t];
+		if (!c->peak)
+			continue;
+		gi.cprintf (NULL, PRINT_HIGH, "%-5s %-14s %10i %7i %10i\n", mem_tagnames[t], "",
+			c->bytes, c->blocks, c->peak);
+		for (i=0 ; i<MEM_NUMSUBS ; i++)
+		{
+			c = &mem_subs[t][i];
+			if (!c->peak)
+				continue;
+			gi.cprintf (NULL, PRINT_HIGH, "      %-14s %10i %7i %10i\n", mem_subnames[i],
+				c->bytes, c->blocks, c->peak);
+		}
+	}
+
+	gi.cprintf (NULL, PRINT_HIGH, "total %i bytes, peak %i this level, %i last level\n",
+		mem_total, mem_levelpeak, mem_lastpeak);
+
+	G_ArenaStats (&arena);
+	gi.cprintf (NULL, PRINT_HIGH, "level arena: %i allocs, %i bytes used of %i, %i strings, %i unique\n",
+		arena.allocs, arena.used, arena.bytes, arena.strings, arena.unique);
+
+	gi.cprintf (NULL, PRINT_HIGH, "edicts: %i in use, peak %i, of %i at %i bytes\n",
+		globals.num_edicts, mem_edictpeak, game.maxentities, (int)sizeof(edict_t));
+
+	if (mem_leaked)
+		gi.cprintf (NULL, PRINT_HIGH, "game memory has grown %i bytes over %i levels\n",
+			mem_leaked, mem_levels);
+}
@@ -92,7 +92,11 @@ gibs
 void gib_think (edict_t *self)
 {
 	self->s.frame++;
+/*freeze
 	self->nextthink = level.time + FRAMETIME;
+freeze*/
+	self->nextthink = level.time + BASETIME;
+/*freeze*/
 
 	if (self->s.frame == 10)
 	{
@@ -122,7 +126,11 @@ void gib_touch (edict_t *self, edict_t *other, cplane_t *plane, csurface_t *surf
 		{
 			self->s.frame++;
 			self->think = gib_think;
+/*freeze
 			self->nextthink = level.time + FRAMETIME;
+freeze*/
+			self->nextthink = level.time + BASETIME;
+/*freeze*/
 		}
 	}
 }
@@ -141,7 +149,7 @@ void ThrowGib (edict_t *self, char *gibname, int damage, int type)
 	float	vscale;
 
 /*freeze*/
-	if (gibCheck())
+	if (gibCheck(self))
 		return;
 /*freeze*/
 	gib = G_Spawn();
@@ -175,6 +175,9 @@ void M_CheckGround (edict_t *ent)
 		VectorCopy (trace.endpos, ent->s.origin);
 		ent->groundentity = trace.ent;
 		ent->groundentity_linkcount = trace.ent->linkcount;
+/*freeze*/
+		G_AddRider (ent);
+/*freeze*/
 		ent->velocity[2] = 0;
 	}
 }
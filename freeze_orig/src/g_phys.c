@@ -237,6 +237,9 @@ int SV_FlyMove (edict_t *ent, float time, int mask)
 			{
 				ent->groundentity = hit;
 				ent->groundentity_linkcount = hit->linkcount;
+/*freeze*/
+				G_AddRider (ent);
+/*freeze*/
 			}
 		}
 		if (!trace.plane.normal[2])
@@ -392,6 +395,51 @@ pushed_t	pushed[MAX_EDICTS], *pushed_p;
 
 edict_t	*obstacle;
 
+/*freeze*/
+static int SV_CompareIndex (const void *a, const void *b)
+{
+	return *(int *)a - *(int *)b;
+}
+
+/*
+============
+SV_PushCandidates
+
+What is standing on the pusher and everything linked near where it is
+going, in edict order.  These are the only entities SV_Push can move.
+============
+*/
+static int SV_PushCandidates (edict_t *pusher, vec3_t mins, vec3_t maxs, int *list)
+{
+	static int	mark[MAX_EDICTS], stamp;
+	edict_t		*touch[MAX_EDICTS];
+	int			count, n, i, e, type;
+
+	stamp++;
+	count = G_Riders (pusher, list);
+	for (i=0 ; i<count ; i++)
+		mark[list[i]] = stamp;
+
+	for (type = AREA_SOLID ; type <= AREA_TRIGGERS ; type++)
+	{
+		n = gi.BoxEdicts (mins, maxs, touch, MAX_EDICTS, type);
+		for (i=0 ; i<n ; i++)
+		{
+			e = touch[i] - g_edicts;
+			if (mark[e] == stamp)
+				continue;
+			mark[e] = stamp;
+			list[count++] = e;
+		}
+	}
+
+	// pushing order decides who blocks
+	if (count > 1)
+		qsort (list, count, sizeof(*list), SV_CompareIndex);
+	return count;
+}
+/*freeze*/
+
 /*
 ============
 SV_Push
@@ -403,6 +451,10 @@ otherwise riders would continue to slide.
 qboolean SV_Push (edict_t *pusher, vec3_t move, vec3_t amove)
 {
 	int			i, e;
+/*freeze*/
+	int			k, count;
+	int			candidates[MAX_EDICTS];
+/*freeze*/
 	edict_t		*check, *block;
 	vec3_t		mins, maxs;
 	pushed_t	*p;
@@ -446,10 +498,22 @@ qboolean SV_Push (edict_t *pusher, vec3_t move, vec3_t amove)
 	gi.linkentity (pusher);
 
 // see if any solid entities are inside the final position
+/*freeze
 	check = g_edicts+1;
 	for (e = 1; e < globals.num_edicts; e++, check++)
 	{
+freeze*/
+	count = SV_PushCandidates (pusher, mins, maxs, candidates);
+	for (k = 0; k < count; k++)
+	{
+		e = candidates[k];
+		check = g_edicts + e;
+/*freeze*/
+/*freeze
 		if (!check->inuse)
+freeze*/
+		if (!g_hot.inuse[e] || !g_hot.linked[e])
+/*freeze*/
 			continue;
 		if (check->movetype == MOVETYPE_PUSH
 		|| check->movetype == MOVETYPE_STOP
@@ -730,6 +794,9 @@ void SV_Physics_Toss (edict_t *ent)
 			{
 				ent->groundentity = trace.ent;
 				ent->groundentity_linkcount = trace.ent->linkcount;
+/*freeze*/
+				G_AddRider (ent);
+/*freeze*/
 				VectorCopy (vec3_origin, ent->velocity);
 				VectorCopy (vec3_origin, ent->avelocity);
 			}
@@ -0,0 +1,146 @@
+// g_prof.c -- lightweight timing of game subsystems
+
+#include "g_local.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+/*
+==============================================================================
+
+Sections are timed with G_ProfBegin / G_ProfEnd while the profile cvar is
+set, and may nest or be entered several times a frame.  G_ProfFrame closes
+out each frame.  "sv prof" prints the totals, "sv prof reset" clears them.
+
+==============================================================================
+*/
+
+typedef struct
+{
+	char	*name;
+	double	start;
+	double	frame;		// time spent this frame
+	double	total;
+	double	max;		// worst frame
+	int		calls;
+} profsection_t;
+
+static profsection_t	prof_sections[PROF_NUMSECTIONS] =
+{
+	{"frame"},
+	{"lag rewind"},
+	{"client views"}
+};
+
+static int	prof_frames;
+
+cvar_t	*profile;
+
+/*
+=================
+G_ProfTime
+
+Seconds from an arbitrary start, as precise as the system allows.
+=================
+*/
+double G_ProfTime (void)
+{
+#ifdef _WIN32
+	static LARGE_INTEGER	freq;
+	LARGE_INTEGER			count;
+
+	if (!freq.QuadPart)
+		QueryPerformanceFrequency (&freq);
+	QueryPerformanceCounter (&count);
+	return (double)count.QuadPart / freq.QuadPart;
+#else
+	struct timespec	ts;
+
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
+
+void G_InitProf (void)
+{
+	profile = gi.cvar ("profile", "0", 0);
+}
+
+void G_ProfBegin (int section)
+{
+	if (!profile->value)
+		return;
+	prof_sections[section].start = G_ProfTime ();
+}
+
+void G_ProfEnd (int section)
+{
+	profsection_t	*s;
+
+	if (!profile->value)
+		return;
+	s = &prof_sections[section];
+	s->frame += G_ProfTime () - s->start;
+	s->calls++;
+}
+
+/*
+=================
+G_ProfFrame
+
+Called at the end of every G_RunFrame.
+=================
+*/
+void G_ProfFrame (void)
+{
+	int				i;
+	profsection_t	*s;
+
+	if (!profile->value)
+		return;
+
+	prof_frames++;
+	for (i=0, s=prof_sections ; i<PROF_NUMSECTIONS ; i++, s++)
+	{
+		s->total += s->frame;
+		if (s->frame > s->max)
+			s->max = s->frame;
+		s->frame = 0;
+	}
+}
+
+/*
+=================
+SVCmd_Prof_f
+=================
+*/
+void SVCmd_Prof_f (void)
+{
+	int				i;
+	profsection_t	*s;
+
+	if (!Q_stricmp (gi.argv(2), "reset"))
+	{
+		for (i=0, s=prof_sections ; i<PROF_NUMSECTIONS ; i++, s++)
+			s->total = s->max = s->frame = s->calls = 0;
+		prof_frames = 0;
+		return;
+	}
+
+	if (!profile->value && !prof_frames)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "Set profile 1 to start timing.\n");
+		return;
+	}
+
+	gi.cprintf (NULL, PRINT_HIGH, "%i frames\n", prof_frames);
+	gi.cprintf (NULL, PRINT_HIGH, "section          calls   ms/frame    max ms\n");
+	for (i=0, s=prof_sections ; i<PROF_NUMSECTIONS ; i++, s++)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "%-14s %7i %10.4f %9.3f\n", s->name, s->calls,
+			prof_frames ? s->total * 1000 / prof_frames : 0, s->max * 1000);
+	}
+	G_MemSummary ();
+}
@@ -0,0 +1,774 @@
+// g_replay.c -- recording a level's client input and playing it back
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+"sv record <name>" records the next level into <game>/<name>.frp, until
+the level after it starts or "sv record stop".  Everything the engine
+hands the game is written down as it comes in: connects, userinfo,
+begins, disconnects, client commands, every usercmd with the client's
+ping, and each frame with a checksum of the entity state after it.
+
+"sv replay <name>" feeds a recording back through the same entry points
+as fast as it can, on a server running the same map with nobody on it,
+and reports the time taken and any frame whose checksum came out
+different.  The map is reloaded afterwards.
+
+rand is reseeded from the level seed and a call count before every entry
+point while recording or replaying, so whatever the engine does with rand
+between calls doesn't matter.  Clients carried over from the level before
+are reconnected from their userinfo, so their first frames are only as
+exact as that is.
+
+Each record is a type byte and an int length, then the data, in the byte
+order of the machine that wrote it.
+
+==============================================================================
+*/
+
+#define	RP_MAGIC		(('1'<<24)|('P'<<16)|('R'<<8)|'F')
+#define	RP_VERSION		1
+#define	RP_FLUSH		65536		// bytes buffered before they go to disk
+
+#define	RP_LEVEL		1		// int seed, mapname, spawnpoint, entities
+#define	RP_CARRY		2		// byte client, userinfo
+#define	RP_SPAWN		3
+#define	RP_CONNECT		4		// byte client, byte accepted, userinfo
+#define	RP_USERINFO		5		// byte client, userinfo
+#define	RP_BEGIN		6		// byte client
+#define	RP_DISCONNECT	7		// byte client
+#define	RP_COMMAND		8		// byte client, byte argc, argv strings, args
+#define	RP_THINK		9		// byte client, short ping, usercmd_t
+#define	RP_FRAME		10		// int framenum, int checksum
+
+static game_export_t	real;			// the entry points before they were wrapped
+static game_import_t	engine;			// gi while a replay has parts of it replaced
+
+static iobuf_t		rp_buf;
+static int			rp_record;		// offset of the record being written
+static char			rp_filename[MAX_OSPATH];
+static char			rp_armed[MAX_OSPATH];	// starts at the next level
+static qboolean		rp_recording;
+static qboolean		rp_written;		// rp_filename has been created
+static int			rp_frames;
+
+static qboolean		rp_replaying;
+static unsigned		rp_seed;
+static unsigned		rp_calls;
+
+// ClientCommand arguments during a replay
+static int			rp_argc;
+static char			*rp_argv[MAX_STRING_TOKENS];
+static char			*rp_args;
+
+/*
+==============================================================================
+
+WRITING
+
+==============================================================================
+*/
+
+static void RP_Begin (int type)
+{
+	byte	header[5];
+
+	rp_record = rp_buf.cursize;
+	header[0] = type;
+	memset (header + 1, 0, 4);
+	G_IOBufWrite (&rp_buf, header, 5);
+}
+
+static void RP_End (void)
+{
+	int		len;
+
+	len = rp_buf.cursize - rp_record - 5;
+	memcpy (rp_buf.data + rp_record + 1, &len, 4);
+}
+
+static void RP_Byte (int c)
+{
+	byte	b;
+
+	b = c;
+	G_IOBufWrite (&rp_buf, &b, 1);
+}
+
+static void RP_Short (int c)
+{
+	short	s;
+
+	s = c;
+	G_IOBufWrite (&rp_buf, &s, 2);
+}
+
+static void RP_Int (int c)
+{
+	G_IOBufWrite (&rp_buf, &c, 4);
+}
+
+static void RP_String (char *s)
+{
+	G_IOBufWrite (&rp_buf, s, strlen (s) + 1);
+}
+
+static void RP_Flush (void)
+{
+	if (!rp_buf.cursize)
+		return;
+	if (rp_written)
+		G_AppendFile (rp_filename, rp_buf.data, rp_buf.cursize, NULL, NULL);
+	else
+		G_WriteFile (rp_filename, rp_buf.data, rp_buf.cursize, NULL, NULL);
+	rp_written = true;
+	rp_buf.cursize = 0;
+}
+
+static unsigned RP_Hash (unsigned hash, void *data, int length)
+{
+	byte	*p;
+
+	for (p = data ; length-- ; p++)
+		hash = (hash ^ *p) * 16777619;
+	return hash;
+}
+
+/*
+=================
+RP_Checksum
+
+The entity state every client would be sent, and some of the player state.
+=================
+*/
+static unsigned RP_Checksum (void)
+{
+	unsigned	hash;
+	edict_t		*ent;
+	int			i;
+
+	hash = 2166136261u;
+	for (i=0, ent=g_edicts ; i<globals.num_edicts ; i++, ent++)
+	{
+		if (!ent->inuse)
+			continue;
+		hash = RP_Hash (hash, &i, sizeof(i));
+		hash = RP_Hash (hash, &ent->s, sizeof(ent->s));
+		hash = RP_Hash (hash, &ent->health, sizeof(ent->health));
+		if (!ent->client)
+			continue;
+		hash = RP_Hash (hash, ent->client->ps.pmove.origin, sizeof(ent->client->ps.pmove.origin));
+		hash = RP_Hash (hash, ent->client->ps.pmove.velocity, sizeof(ent->client->ps.pmove.velocity));
+		hash = RP_Hash (hash, ent->client->ps.viewangles, sizeof(ent->client->ps.viewangles));
+		hash = RP_Hash (hash, ent->client->ps.stats, sizeof(ent->client->ps.stats));
+	}
+	return hash;
+}
+
+static void RP_Seed (void)
+{
+	if (rp_recording || rp_replaying)
+		srand (rp_seed + rp_calls++ * 2654435761u);
+}
+
+static void RP_StartRecording (char *mapname, char *entities, char *spawnpoint)
+{
+	cvar_t	*gamedir;
+	int		i;
+
+	gamedir = gi.cvar ("game", "", 0);
+	Com_sprintf (rp_filename, sizeof(rp_filename), "%s/%s.frp",
+		*gamedir->string ? gamedir->string : GAMEVERSION, rp_armed);
+	rp_armed[0] = 0;
+
+	rp_recording = true;
+	rp_written = false;
+	rp_frames = 0;
+	rp_seed = time (NULL);
+	rp_calls = 0;
+	rp_buf.cursize = 0;
+
+	RP_Int (RP_MAGIC);
+	RP_Int (RP_VERSION);
+
+	RP_Begin (RP_LEVEL);
+	RP_Int (rp_seed);
+	RP_String (mapname);
+	RP_String (spawnpoint ? spawnpoint : "");
+	RP_String (entities);
+	RP_End ();
+
+	for (i=0 ; i<game.maxclients ; i++)
+	{
+		if (!game.clients[i].pers.connected)
+			continue;
+		RP_Begin (RP_CARRY);
+		RP_Byte (i);
+		RP_String (game.clients[i].pers.userinfo);
+		RP_End ();
+	}
+
+	RP_Begin (RP_SPAWN);
+	RP_End ();
+
+	gi.dprintf ("Recording to %s\n", rp_filename);
+}
+
+static void RP_StopRecording (void)
+{
+	if (!rp_recording)
+		return;
+	RP_Flush ();
+	rp_recording = false;
+	gi.dprintf ("Recorded %i frames to %s\n", rp_frames, rp_filename);
+}
+
+/*
+==============================================================================
+
+THE WRAPPED ENTRY POINTS
+
+==============================================================================
+*/
+
+static void RP_SpawnEntities (char *mapname, char *entities, char *spawnpoint)
+{
+	// one level to a file
+	RP_StopRecording ();
+	if (rp_armed[0] && !rp_replaying)
+		RP_StartRecording (mapname, entities, spawnpoint);
+
+	RP_Seed ();
+	real.SpawnEntities (mapname, entities, spawnpoint);
+}
+
+static qboolean RP_ClientConnect (edict_t *ent, char *userinfo)
+{
+	char		in[MAX_INFO_STRING];
+	qboolean	accepted;
+
+	if (rp_recording)
+	{
+		strncpy (in, userinfo, sizeof(in) - 1);
+		in[sizeof(in) - 1] = 0;
+	}
+
+	RP_Seed ();
+	accepted = real.ClientConnect (ent, userinfo);
+
+	if (rp_recording)
+	{
+		RP_Begin (RP_CONNECT);
+		RP_Byte (ent - g_edicts - 1);
+		RP_Byte (accepted);
+		RP_String (in);
+		RP_End ();
+	}
+	return accepted;
+}
+
+static void RP_ClientUserinfoChanged (edict_t *ent, char *userinfo)
+{
+	if (rp_recording)
+	{
+		RP_Begin (RP_USERINFO);
+		RP_Byte (ent - g_edicts - 1);
+		RP_String (userinfo);
+		RP_End ();
+	}
+	RP_Seed ();
+	real.ClientUserinfoChanged (ent, userinfo);
+}
+
+static void RP_ClientBegin (edict_t *ent)
+{
+	if (rp_recording)
+	{
+		RP_Begin (RP_BEGIN);
+		RP_Byte (ent - g_edicts - 1);
+		RP_End ();
+	}
+	RP_Seed ();
+	real.ClientBegin (ent);
+}
+
+static void RP_ClientDisconnect (edict_t *ent)
+{
+	if (rp_recording)
+	{
+		RP_Begin (RP_DISCONNECT);
+		RP_Byte (ent - g_edicts - 1);
+		RP_End ();
+	}
+	RP_Seed ();
+	real.ClientDisconnect (ent);
+}
+
+static void RP_ClientCommand (edict_t *ent)
+{
+	int		i, argc;
+
+	if (rp_recording)
+	{
+		argc = gi.argc ();
+		if (argc > MAX_STRING_TOKENS)
+			argc = MAX_STRING_TOKENS;
+		RP_Begin (RP_COMMAND);
+		RP_Byte (ent - g_edicts - 1);
+		RP_Byte (argc);
+		for (i=0 ; i<argc ; i++)
+			RP_String (gi.argv (i));
+		RP_String (gi.args ());
+		RP_End ();
+	}
+	RP_Seed ();
+	real.ClientCommand (ent);
+}
+
+static void RP_ClientThink (edict_t *ent, usercmd_t *cmd)
+{
+	if (rp_recording)
+	{
+		RP_Begin (RP_THINK);
+		RP_Byte (ent - g_edicts - 1);
+		RP_Short (ent->client->ping);
+		G_IOBufWrite (&rp_buf, cmd, sizeof(*cmd));
+		RP_End ();
+	}
+	RP_Seed ();
+	real.ClientThink (ent, cmd);
+}
+
+static void RP_RunFrame (void)
+{
+	RP_Seed ();
+	real.RunFrame ();
+
+	if (rp_recording)
+	{
+		RP_Begin (RP_FRAME);
+		RP_Int (level.framenum);
+		RP_Int (RP_Checksum ());
+		RP_End ();
+		rp_frames++;
+		if (rp_buf.cursize >= RP_FLUSH)
+			RP_Flush ();
+	}
+}
+
+/*
+=================
+G_InitReplay
+
+Puts the recorder between the engine and the game.
+=================
+*/
+void G_InitReplay (void)
+{
+	if (globals.ClientThink == RP_ClientThink)
+		return;
+
+	real = globals;
+	globals.SpawnEntities = RP_SpawnEntities;
+	globals.ClientConnect = RP_ClientConnect;
+	globals.ClientUserinfoChanged = RP_ClientUserinfoChanged;
+	globals.ClientBegin = RP_ClientBegin;
+	globals.ClientDisconnect = RP_ClientDisconnect;
+	globals.ClientCommand = RP_ClientCommand;
+	globals.ClientThink = RP_ClientThink;
+	globals.RunFrame = RP_RunFrame;
+}
+
+void G_ShutdownReplay (void)
+{
+	RP_StopRecording ();
+	rp_armed[0] = 0;
+	G_FreeIOBuf (&rp_buf);
+}
+
+/*
+==============================================================================
+
+PLAYING BACK
+
+The replayed clients aren't connected as far as the engine knows, so
+anything sent to one of them is thrown away.
+
+==============================================================================
+*/
+
+static int RP_Argc (void)
+{
+	return rp_argc;
+}
+
+static char *RP_Argv (int n)
+{
+	if (n < 0 || n >= rp_argc)
+		return "";
+	return rp_argv[n];
+}
+
+static char *RP_Args (void)
+{
+	return rp_args;
+}
+
+static void RP_Cprintf (edict_t *ent, int printlevel, char *fmt, ...)
+{
+	va_list		argptr;
+	char		text[1024];
+
+	if (ent)
+		return;
+	va_start (argptr, fmt);
+	vsnprintf (text, sizeof(text), fmt, argptr);
+	va_end (argptr);
+	text[sizeof(text)-1] = 0;
+	engine.cprintf (NULL, printlevel, "%s", text);
+}
+
+static void RP_Centerprintf (edict_t *ent, char *fmt, ...)
+{
+}
+
+static void RP_Bprintf (int printlevel, char *fmt, ...)
+{
+}
+
+static void RP_Unicast (edict_t *ent, qboolean reliable)
+{
+	// nobody is connected, so this just clears the message
+	engine.multicast (vec3_origin, MULTICAST_ALL);
+}
+
+/*
+=================
+RP_Next
+
+Steps to the next record, false at the end or if it runs off the end.
+=================
+*/
+static qboolean RP_Next (byte **p, byte *end, int *type, byte **data, int *length)
+{
+	if (*p + 5 > end)
+		return false;
+	*type = (*p)[0];
+	memcpy (length, *p + 1, 4);
+	*data = *p + 5;
+	if (*length < 0 || *data + *length > end)
+		return false;
+	*p = *data + *length;
+	return true;
+}
+
+/*
+=================
+RP_GetString
+
+The string at *s if its 0 comes before end, and steps *s past it.
+NULL if a damaged record would run it off the end.
+=================
+*/
+static char *RP_GetString (byte **s, byte *end)
+{
+	byte	*z;
+	char	*string;
+
+	if (*s >= end)
+		return NULL;
+	z = memchr (*s, 0, end - *s);
+	if (!z)
+		return NULL;
+	string = (char *)*s;
+	*s = z + 1;
+	return string;
+}
+
+/*
+=================
+SVCmd_Record_f
+
+sv record <name> | stop
+=================
+*/
+void SVCmd_Record_f (void)
+{
+	char	*name;
+
+	name = gi.argv(2);
+	if (!*name)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "Usage: sv record <name> | stop\n");
+		return;
+	}
+
+	if (!Q_stricmp (name, "stop"))
+	{
+		if (!rp_recording && !rp_armed[0])
+			gi.cprintf (NULL, PRINT_HIGH, "Not recording.\n");
+		rp_armed[0] = 0;
+		RP_StopRecording ();
+		return;
+	}
+
+	if (strstr (name, "..") || strchr (name, '/') || strchr (name, '\\'))
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "Bad name.\n");
+		return;
+	}
+
+	Com_sprintf (rp_armed, sizeof(rp_armed), "%s", name);
+	gi.cprintf (NULL, PRINT_HIGH, "Recording starts with the next level.\n");
+}
+
+/*
+=================
+SVCmd_Replay_f
+
+sv replay <name>
+=================
+*/
+void SVCmd_Replay_f (void)
+{
+	char		filename[MAX_OSPATH];
+	char		userinfo[MAX_INFO_STRING];
+	char		*file, *mapname, *spawnpoint, *entities, *s;
+	byte		*p, *end, *data, *field, *dataend;
+	cvar_t		*gamedir;
+	edict_t		*ent;
+	usercmd_t	cmd;
+	int			length, type, version, i, n, len;
+	int			frames, mismatches, firstbad, framenum;
+	unsigned	checksum;
+	qboolean	damaged;
+	double		start, t, worst;
+	short		ping;
+
+	if (gi.argc() < 3)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "Usage: sv replay <name>\n");
+		return;
+	}
+	if (rp_recording || rp_replaying)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "Can't replay while recording.\n");
+		return;
+	}
+	for (i=0 ; i<game.maxclients ; i++)
+	{
+		if (game.clients[i].pers.connected)
+		{
+			gi.cprintf (NULL, PRINT_HIGH, "Replays need a server with nobody on it.\n");
+			return;
+		}
+	}
+
+	gamedir = gi.cvar ("game", "", 0);
+	Com_sprintf (filename, sizeof(filename), "%s/%s.frp",
+		*gamedir->string ? gamedir->string : GAMEVERSION, gi.argv(2));
+	file = G_LoadFile (filename, &length, NULL);
+	if (!file)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "Couldn't read %s\n", filename);
+		return;
+	}
+
+	p = (byte *)file;
+	end = p + length;
+	if (length < 8 || ((int *)p)[0] != RP_MAGIC)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "%s isn't a recording\n", filename);
+		G_FreeFile (file);
+		return;
+	}
+	memcpy (&version, p + 4, 4);
+	if (version != RP_VERSION)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "%s is version %i, not %i\n", filename, version, RP_VERSION);
+		G_FreeFile (file);
+		return;
+	}
+	p += 8;
+
+	if (!RP_Next (&p, end, &type, &data, &len) || type != RP_LEVEL || len < 7)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "%s doesn't start with a level\n", filename);
+		G_FreeFile (file);
+		return;
+	}
+	memcpy (&rp_seed, data, 4);
+	field = data + 4;
+	mapname = RP_GetString (&field, data + len);
+	spawnpoint = RP_GetString (&field, data + len);
+	entities = RP_GetString (&field, data + len);
+	if (!mapname || !spawnpoint || !entities)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "%s has a damaged level record\n", filename);
+		G_FreeFile (file);
+		return;
+	}
+	if (Q_stricmp (mapname, level.mapname))
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "Load %s first.\n", mapname);
+		G_FreeFile (file);
+		return;
+	}
+
+	engine = gi;
+	gi.argc = RP_Argc;
+	gi.argv = RP_Argv;
+	gi.args = RP_Args;
+	gi.cprintf = RP_Cprintf;
+	gi.centerprintf = RP_Centerprintf;
+	gi.bprintf = RP_Bprintf;
+	gi.unicast = RP_Unicast;
+	rp_replaying = true;
+	rp_calls = 0;
+
+	frames = mismatches = firstbad = 0;
+	worst = 0;
+	start = G_ProfTime ();
+
+	damaged = false;
+	while (!damaged && RP_Next (&p, end, &type, &data, &len))
+	{
+		dataend = data + len;
+		n = len ? data[0] : 0;
+		ent = g_edicts + 1 + n;
+		if (type != RP_SPAWN && type != RP_FRAME && n >= game.maxclients)
+			break;
+
+		// every field has to lie within the record
+		field = data + 1;
+		switch (type)
+		{
+		case RP_CARRY:
+			if (!(s = RP_GetString (&field, dataend)))
+			{
+				damaged = true;
+				break;
+			}
+			Com_sprintf (userinfo, sizeof(userinfo), "%s", s);
+			real.ClientConnect (ent, userinfo);
+			break;
+		case RP_SPAWN:
+			globals.SpawnEntities (mapname, entities, spawnpoint);
+			break;
+		case RP_CONNECT:
+			field = data + 2;
+			if (!(s = RP_GetString (&field, dataend)))
+			{
+				damaged = true;
+				break;
+			}
+			Com_sprintf (userinfo, sizeof(userinfo), "%s", s);
+			if (globals.ClientConnect (ent, userinfo) != data[1])
+				gi.dprintf ("replay: client %i connect went differently\n", n);
+			break;
+		case RP_USERINFO:
+			if (!(s = RP_GetString (&field, dataend)))
+			{
+				damaged = true;
+				break;
+			}
+			Com_sprintf (userinfo, sizeof(userinfo), "%s", s);
+			globals.ClientUserinfoChanged (ent, userinfo);
+			break;
+		case RP_BEGIN:
+			if (len < 1)
+			{
+				damaged = true;
+				break;
+			}
+			globals.ClientBegin (ent);
+			break;
+		case RP_DISCONNECT:
+			if (len < 1)
+			{
+				damaged = true;
+				break;
+			}
+			globals.ClientDisconnect (ent);
+			break;
+		case RP_COMMAND:
+			if (len < 2 || data[1] > MAX_STRING_TOKENS)
+			{
+				damaged = true;
+				break;
+			}
+			rp_argc = data[1];
+			field = data + 2;
+			for (i=0 ; i<rp_argc ; i++)
+				if (!(rp_argv[i] = RP_GetString (&field, dataend)))
+					break;
+			if (i < rp_argc || !(rp_args = RP_GetString (&field, dataend)))
+			{
+				rp_argc = 0;
+				rp_args = "";
+				damaged = true;
+				break;
+			}
+			globals.ClientCommand (ent);
+			break;
+		case RP_THINK:
+			if (len < 3 + (int)sizeof(cmd))
+			{
+				damaged = true;
+				break;
+			}
+			memcpy (&ping, data + 1, 2);
+			memcpy (&cmd, data + 3, sizeof(cmd));
+			if (ent->client)
+				ent->client->ping = ping;
+			globals.ClientThink (ent, &cmd);
+			break;
+		case RP_FRAME:
+			if (len < 8)
+			{
+				damaged = true;
+				break;
+			}
+			t = G_ProfTime ();
+			globals.RunFrame ();
+			t = G_ProfTime () - t;
+			if (t > worst)
+				worst = t;
+			frames++;
+			memcpy (&framenum, data, 4);
+			memcpy (&checksum, data + 4, 4);
+			if (RP_Checksum () != checksum || level.framenum != framenum)
+			{
+				if (!mismatches)
+					firstbad = frames;
+				mismatches++;
+			}
+			break;
+		}
+	}
+	if (damaged || p != end)
+		gi.cprintf (NULL, PRINT_HIGH, "%s has a damaged record after frame %i, replay stopped\n",
+			filename, frames);
+	t = G_ProfTime () - start;
+
+	// nobody stays behind
+	for (i=0 ; i<game.maxclients ; i++)
+		if (game.clients[i].pers.connected)
+			globals.ClientDisconnect (g_edicts + 1 + i);
+
+	rp_replaying = false;
+	gi = engine;
+
+	gi.cprintf (NULL, PRINT_HIGH, "%i frames in %.3f seconds, %.3f ms a frame, worst %.3f ms\n",
+		frames, t, frames ? t * 1000 / frames : 0, worst * 1000);
+	if (mismatches)
+		gi.cprintf (NULL, PRINT_HIGH, "%i frames differ from the recording, the first is frame %i\n",
+			mismatches, firstbad);
+	else
+		gi.cprintf (NULL, PRINT_HIGH, "every frame matches the recording\n");
+
+	G_FreeFile (file);
+	gi.AddCommandString (va ("map %s\n", level.mapname));
+}
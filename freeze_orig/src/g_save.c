@@ -204,6 +204,27 @@ void InitGame (void)
 	sv_maplist = gi.cvar ("sv_maplist", "", 0);
 
 /*freeze*/
+	// only whole multiples of 10hz, so BASETIME is always a whole
+	// number of frames
+	framediv = gi.cvar ("sv_fps", "10", CVAR_LATCH)->value / 10;
+	if (framediv < 1)
+		framediv = 1;
+	else if (framediv > 6)
+		framediv = 6;
+	frametime = BASETIME / framediv;
+	if (framediv > 1)
+		gi.dprintf ("running at %i frames a second\n", framediv * 10);
+
+	G_InitMem ();
+	G_InitIO ();
+	G_InitJournal ();
+	SV_InitIPFilters ();
+	G_InitProf ();
+	G_InitLag ();
+	G_InitBsp ();
+	G_InitVec ();
+	G_InitConfigstrings ();
+	G_InitEffects ();
 	cvarFreeze();
 /*freeze*/
 	// items
@@ -215,19 +236,36 @@ void InitGame (void)
 
 	// initialize all entities for this game
 	game.maxentities = maxentities->value;
+/*freeze
 	g_edicts =  gi.TagMalloc (game.maxentities * sizeof(g_edicts[0]), TAG_GAME);
+freeze*/
+	g_edicts =  G_TagMalloc (game.maxentities * sizeof(g_edicts[0]), TAG_GAME, MEM_EDICTS);
+/*freeze*/
 	globals.edicts = g_edicts;
 	globals.max_edicts = game.maxentities;
 
 	// initialize all clients for this game
 	game.maxclients = maxclients->value;
+/*freeze
 	game.clients = gi.TagMalloc (game.maxclients * sizeof(game.clients[0]), TAG_GAME);
+freeze*/
+	game.clients = G_TagMalloc (game.maxclients * sizeof(game.clients[0]), TAG_GAME, MEM_CLIENTS);
+/*freeze*/
 	globals.num_edicts = game.maxclients+1;
+/*freeze*/
+	G_InitHot ();
+	G_InitJobs ();
+	G_InitReplay ();
+/*freeze*/
 }
 
 //=========================================================
 
+/*freeze
 void WriteField1 (FILE *f, field_t *field, byte *base)
+freeze*/
+void WriteField1 (iobuf_t *f, field_t *field, byte *base)
+/*freeze*/
 {
 	void		*p;
 	int			len;
@@ -300,7 +338,11 @@ void WriteField1 (FILE *f, field_t *field, byte *base)
 }
 
 
+/*freeze
 void WriteField2 (FILE *f, field_t *field, byte *base)
+freeze*/
+void WriteField2 (iobuf_t *f, field_t *field, byte *base)
+/*freeze*/
 {
 	int			len;
 	void		*p;
@@ -315,7 +357,11 @@ void WriteField2 (FILE *f, field_t *field, byte *base)
 		if ( *(char **)p )
 		{
 			len = strlen(*(char **)p) + 1;
+/*freeze
 			fwrite (*(char **)p, len, 1, f);
+freeze*/
+			G_IOBufWrite (f, *(char **)p, len);
+/*freeze*/
 		}
 		break;
 	}
@@ -346,7 +392,11 @@ void ReadField (FILE *f, field_t *field, byte *base)
 			*(char **)p = NULL;
 		else
 		{
+/*freeze
 			*(char **)p = gi.TagMalloc (len, TAG_LEVEL);
+freeze*/
+			*(char **)p = G_TagMalloc (len, TAG_LEVEL, MEM_SAVE);
+/*freeze*/
 			fread (*(char **)p, len, 1, f);
 		}
 		break;
@@ -404,7 +454,11 @@ WriteClient
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
+/*freeze
 void WriteClient (FILE *f, gclient_t *client)
+freeze*/
+void WriteClient (iobuf_t *f, gclient_t *client)
+/*freeze*/
 {
 	field_t		*field;
 	gclient_t	temp;
@@ -419,7 +473,11 @@ void WriteClient (FILE *f, gclient_t *client)
 	}
 
 	// write the block
+/*freeze
 	fwrite (&temp, sizeof(temp), 1, f);
+freeze*/
+	G_IOBufWrite (f, &temp, sizeof(temp));
+/*freeze*/
 
 	// now write any allocated data following the edict
 	for (field=clientfields ; field->name ; field++)
@@ -447,6 +505,25 @@ void ReadClient (FILE *f, gclient_t *client)
 	}
 }
 
+/*freeze*/
+/*
+============
+G_WriteSave
+
+Saves only go out in the background on a dedicated deathmatch server.
+Anywhere else the engine may copy the save directory as soon as we
+return, so wait for the write to land.
+============
+*/
+static void G_WriteSave (char *filename, iobuf_t *buf)
+{
+	G_WriteFile (filename, buf->data, buf->cursize, NULL, NULL);
+	G_FreeIOBuf (buf);
+	if (!deathmatch->value || !dedicated->value)
+		G_FlushIO ();
+}
+/*freeze*/
+
 /*
 ============
 WriteGame
@@ -463,29 +540,49 @@ last save position.
 */
 void WriteGame (char *filename, qboolean autosave)
 {
+/*freeze
 	FILE	*f;
+freeze*/
+	iobuf_t	buf, *f = &buf;
+/*freeze*/
 	int		i;
 	char	str[16];
 
 	if (!autosave)
 		SaveClientData ();
 
+/*freeze
 	f = fopen (filename, "wb");
 	if (!f)
 		gi.error ("Couldn't open %s", filename);
+freeze*/
+	G_InitIOBuf (f);
+/*freeze*/
 
 	memset (str, 0, sizeof(str));
 	strcpy (str, __DATE__);
+/*freeze
 	fwrite (str, sizeof(str), 1, f);
+freeze*/
+	G_IOBufWrite (f, str, sizeof(str));
+/*freeze*/
 
 	game.autosaved = autosave;
+/*freeze
 	fwrite (&game, sizeof(game), 1, f);
+freeze*/
+	G_IOBufWrite (f, &game, sizeof(game));
+/*freeze*/
 	game.autosaved = false;
 
 	for (i=0 ; i<game.maxclients ; i++)
 		WriteClient (f, &game.clients[i]);
 
+/*freeze
 	fclose (f);
+freeze*/
+	G_WriteSave (filename, f);
+/*freeze*/
 }
 
 void ReadGame (char *filename)
@@ -494,6 +591,9 @@ void ReadGame (char *filename)
 	int		i;
 	char	str[16];
 
+/*freeze*/
+	G_FlushIO ();
+/*freeze*/
 	gi.FreeTags (TAG_GAME);
 
 	f = fopen (filename, "rb");
@@ -507,15 +607,26 @@ void ReadGame (char *filename)
 		gi.error ("Savegame from an older version.\n");
 	}
 
+/*freeze
 	g_edicts =  gi.TagMalloc (game.maxentities * sizeof(g_edicts[0]), TAG_GAME);
+freeze*/
+	g_edicts =  G_TagMalloc (game.maxentities * sizeof(g_edicts[0]), TAG_GAME, MEM_EDICTS);
+/*freeze*/
 	globals.edicts = g_edicts;
 
 	fread (&game, sizeof(game), 1, f);
+/*freeze
 	game.clients = gi.TagMalloc (game.maxclients * sizeof(game.clients[0]), TAG_GAME);
+freeze*/
+	game.clients = G_TagMalloc (game.maxclients * sizeof(game.clients[0]), TAG_GAME, MEM_CLIENTS);
+/*freeze*/
 	for (i=0 ; i<game.maxclients ; i++)
 		ReadClient (f, &game.clients[i]);
 
 	fclose (f);
+/*freeze*/
+	G_SyncAllHot ();
+/*freeze*/
 }
 
 //==========================================================
@@ -528,7 +639,11 @@ WriteEdict
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
+/*freeze
 void WriteEdict (FILE *f, edict_t *ent)
+freeze*/
+void WriteEdict (iobuf_t *f, edict_t *ent)
+/*freeze*/
 {
 	field_t		*field;
 	edict_t		temp;
@@ -543,7 +658,11 @@ void WriteEdict (FILE *f, edict_t *ent)
 	}
 
 	// write the block
+/*freeze
 	fwrite (&temp, sizeof(temp), 1, f);
+freeze*/
+	G_IOBufWrite (f, &temp, sizeof(temp));
+/*freeze*/
 
 	// now write any allocated data following the edict
 	for (field=fields ; field->name ; field++)
@@ -560,7 +679,11 @@ WriteLevelLocals
 All pointer variables (except function pointers) must be handled specially.
 ==============
 */
+/*freeze
 void WriteLevelLocals (FILE *f)
+freeze*/
+void WriteLevelLocals (iobuf_t *f)
+/*freeze*/
 {
 	field_t		*field;
 	level_locals_t		temp;
@@ -575,7 +698,11 @@ void WriteLevelLocals (FILE *f)
 	}
 
 	// write the block
+/*freeze
 	fwrite (&temp, sizeof(temp), 1, f);
+freeze*/
+	G_IOBufWrite (f, &temp, sizeof(temp));
+/*freeze*/
 
 	// now write any allocated data following the edict
 	for (field=levelfields ; field->name ; field++)
@@ -633,20 +760,36 @@ void WriteLevel (char *filename)
 {
 	int		i;
 	edict_t	*ent;
+/*freeze
 	FILE	*f;
+freeze*/
+	iobuf_t	buf, *f = &buf;
+/*freeze*/
 	void	*base;
 
+/*freeze
 	f = fopen (filename, "wb");
 	if (!f)
 		gi.error ("Couldn't open %s", filename);
+freeze*/
+	G_InitIOBuf (f);
+/*freeze*/
 
 	// write out edict size for checking
 	i = sizeof(edict_t);
+/*freeze
 	fwrite (&i, sizeof(i), 1, f);
+freeze*/
+	G_IOBufWrite (f, &i, sizeof(i));
+/*freeze*/
 
 	// write out a function pointer for checking
 	base = (void *)InitGame;
+/*freeze
 	fwrite (&base, sizeof(base), 1, f);
+freeze*/
+	G_IOBufWrite (f, &base, sizeof(base));
+/*freeze*/
 
 	// write out level_locals_t
 	WriteLevelLocals (f);
@@ -657,13 +800,23 @@ void WriteLevel (char *filename)
 		ent = &g_edicts[i];
 		if (!ent->inuse)
 			continue;
+/*freeze
 		fwrite (&i, sizeof(i), 1, f);
+freeze*/
+		G_IOBufWrite (f, &i, sizeof(i));
+/*freeze*/
 		WriteEdict (f, ent);
 	}
 	i = -1;
+/*freeze
 	fwrite (&i, sizeof(i), 1, f);
 
 	fclose (f);
+freeze*/
+	G_IOBufWrite (f, &i, sizeof(i));
+
+	G_WriteSave (filename, f);
+/*freeze*/
 }
 
 
@@ -691,6 +844,9 @@ void ReadLevel (char *filename)
 	void	*base;
 	edict_t	*ent;
 
+/*freeze*/
+	G_FlushIO ();
+/*freeze*/
 	f = fopen (filename, "rb");
 	if (!f)
 		gi.error ("Couldn't open %s", filename);
@@ -698,10 +854,18 @@ void ReadLevel (char *filename)
 	// free any dynamic memory allocated by loading the level
 	// base state
 	gi.FreeTags (TAG_LEVEL);
+/*freeze*/
+	G_ResetArena ();
+/*freeze*/
 
 	// wipe all the entities
 	memset (g_edicts, 0, game.maxentities*sizeof(g_edicts[0]));
 	globals.num_edicts = maxclients->value+1;
+/*freeze*/
+	G_ResetConfigstrings ();
+	G_ClearLag ();
+	G_SyncAllHot ();
+/*freeze*/
 
 	// check edict size
 	fread (&i, sizeof(i), 1, f);
@@ -770,4 +934,7 @@ void ReadLevel (char *filename)
 			if (strcmp(ent->classname, "target_crosslevel_target") == 0)
 				ent->nextthink = level.time + ent->delay;
 	}
+/*freeze*/
+	G_ResetChase ();
+/*freeze*/
 }
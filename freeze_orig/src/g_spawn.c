@@ -320,12 +320,25 @@ char *ED_NewString (char *string)
 {
 	char	*newb, *new_p;
 	int		i,l;
+/*freeze*/
+	char	buf[MAX_TOKEN_CHARS];
+/*freeze*/
 	
 	l = strlen(string) + 1;
 
+/*freeze
 	newb = gi.TagMalloc (l, TAG_LEVEL);
+freeze*/
+	// unescaped into buf and shared, or straight into the arena if too long,
+	// newb is only ever the arena copy
+	newb = l <= sizeof(buf) ? NULL : G_ArenaAlloc (l);
+/*freeze*/
 
+/*freeze
 	new_p = newb;
+freeze*/
+	new_p = newb ? newb : buf;
+/*freeze*/
 
 	for (i=0 ; i< l ; i++)
 	{
@@ -341,6 +354,10 @@ char *ED_NewString (char *string)
 			*new_p++ = string[i];
 	}
 	
+/*freeze*/
+	if (!newb)
+		return G_InternString (buf);
+/*freeze*/
 	return newb;
 }
 
@@ -542,6 +559,16 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 
 	memset (&level, 0, sizeof(level));
 	memset (g_edicts, 0, game.maxentities * sizeof (g_edicts[0]));
+/*freeze*/
+	G_ResetArena ();
+	G_ResetConfigstrings ();
+	G_ResetHud ();
+	G_MemNewLevel ();
+	G_ClearLag ();
+	G_SyncAllHot ();
+	G_ResetChase ();
+	G_LoadBsp (mapname);
+/*freeze*/
 
 	strncpy (level.mapname, mapname, sizeof(level.mapname)-1);
 	strncpy (game.spawnpoint, spawnpoint, sizeof(game.spawnpoint)-1);
@@ -606,6 +633,9 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 	}	
 
 	gi.dprintf ("%i entities inhibited\n", inhibit);
+/*freeze*/
+	G_ArenaReport ();
+/*freeze*/
 
 #ifdef DEBUG
 	i = 1;
@@ -620,6 +650,9 @@ void SpawnEntities (char *mapname, char *entities, char *spawnpoint)
 	G_FindTeams ();
 
 	PlayerTrail_Init ();
+/*freeze*/
+	G_SyncAllHot ();
+/*freeze*/
 }
 
 
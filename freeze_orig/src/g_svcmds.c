@@ -57,6 +57,7 @@ If 0, then only addresses matching the list will be allowed.  This lets you easi
 ==============================================================================
 */
 
+/*freeze
 typedef struct
 {
 	unsigned	mask;
@@ -67,12 +68,89 @@ typedef struct
 
 ipfilter_t	ipfilters[MAX_IPFILTERS];
 int			numipfilters;
+freeze*/
+/*
+Filters are kept in a prefix trie, so checking an address costs the same
+with a handful of filters or maxipfilters (default 1024) of them.
+
+addip and removeip also take a prefix length, "addip 192.246.40.0/22".
+Without one the prefix ends at the last digit that isn't zero, so
+10.0.0.1, which used to match 10.*.*.1, now means the single host.
+
+readip [file]
+Loads the "addip <ip>" commands from listip.cfg, or file, in one go.
+This happens when the game starts unless filterload is 0, and is much
+faster than execing a big list.
+*/
+typedef struct
+{
+	unsigned	prefix;		// network bits, host bits are zero
+	byte		length;		// prefix length, 0 - 32
+	byte		filter;		// an addip covers exactly this prefix
+	int			child[2];	// split on the bit after the prefix, 0 for none
+} ipnode_t;
+
+#define	PREFIX_MASK(len)	((len) ? 0xffffffffu << (32 - (len)) : 0)
+#define	PREFIX_BIT(ip,n)	(((ip) >> (31 - (n))) & 1)
+
+// node 0 is the root, 0.0.0.0/0, so it is never anybody's child
+static ipnode_t	*ipnodes;
+static int		numipnodes;
+static int		maxipnodes;
+static int		freeipnode;		// chained through child[0]
+int				numipfilters;
+
+cvar_t	*maxipfilters;
+cvar_t	*filterload;
+
+static int SV_AllocIPNode (unsigned prefix, int length)
+{
+	int		n;
+
+	if (freeipnode)
+	{
+		n = freeipnode;
+		freeipnode = ipnodes[n].child[0];
+	}
+	else
+	{
+		if (numipnodes == maxipnodes)
+		{
+			maxipnodes = maxipnodes ? maxipnodes * 2 : 256;
+			ipnodes = realloc (ipnodes, maxipnodes * sizeof(ipnode_t));
+			if (!ipnodes)
+				gi.error ("SV_AllocIPNode: out of memory");
+		}
+		n = numipnodes++;
+	}
+	ipnodes[n].prefix = prefix;
+	ipnodes[n].length = length;
+	ipnodes[n].filter = false;
+	ipnodes[n].child[0] = ipnodes[n].child[1] = 0;
+	return n;
+}
+
+static void SV_FreeIPNode (int n)
+{
+	ipnodes[n].child[0] = freeipnode;
+	freeipnode = n;
+}
+
+static void SV_ClearIPFilters (void)
+{
+	numipnodes = 0;
+	freeipnode = 0;
+	numipfilters = 0;
+	SV_AllocIPNode (0, 0);
+}
+/*freeze*/
 
 /*
 =================
 StringToFilter
 =================
 */
+/*freeze
 static qboolean StringToFilter (char *s, ipfilter_t *f)
 {
 	char	num[128];
@@ -114,6 +192,173 @@ static qboolean StringToFilter (char *s, ipfilter_t *f)
 	
 	return true;
 }
+freeze*/
+// a.b.c.d/len, or the old form where the octets are given up to the last
+// one that isn't zero: "addip 192.246.40" filters 192.246.40.0/24.
+static qboolean StringToFilter (char *s, unsigned *prefix, int *length)
+{
+	char	*start;
+	int		i, len;
+	unsigned	ip, n;
+
+	start = s;
+	ip = 0;
+	len = 0;
+	for (i=0 ; i<4 ; i++)
+	{
+		if (*s < '0' || *s > '9')
+			goto bad;
+		n = 0;
+		while (*s >= '0' && *s <= '9')
+		{
+			n = n*10 + *s++ - '0';
+			if (n > 255)
+				goto bad;
+		}
+		ip |= n << (24 - i*8);
+		if (n)
+			len = (i+1)*8;
+
+		if (*s != '.')
+			break;
+		s++;
+	}
+
+	if (*s == '/')
+	{
+		s++;
+		if (*s < '0' || *s > '9')
+			goto bad;
+		len = atoi (s);
+		while (*s >= '0' && *s <= '9')
+			s++;
+		if (len > 32)
+			goto bad;
+	}
+	if (*s)
+		goto bad;
+
+	*prefix = ip & PREFIX_MASK(len);
+	*length = len;
+	return true;
+
+bad:
+	gi.cprintf(NULL, PRINT_HIGH, "Bad filter address: %s\n", start);
+	return false;
+}
+
+/*
+=================
+SV_AddIPFilter
+
+Returns false if the prefix was already filtered.
+=================
+*/
+static qboolean SV_AddIPFilter (unsigned prefix, int length)
+{
+	int		n, c, m, bit, common, limit;
+	unsigned	diff;
+
+	n = 0;
+	while (1)
+	{
+		if (ipnodes[n].length == length)
+		{
+			if (ipnodes[n].filter)
+				return false;
+			ipnodes[n].filter = true;
+			numipfilters++;
+			return true;
+		}
+
+		bit = PREFIX_BIT(prefix, ipnodes[n].length);
+		c = ipnodes[n].child[bit];
+		if (!c)
+		{
+			c = SV_AllocIPNode (prefix, length);
+			ipnodes[c].filter = true;
+			ipnodes[n].child[bit] = c;
+			numipfilters++;
+			return true;
+		}
+
+		// how much of the child's prefix is shared
+		limit = ipnodes[c].length < length ? ipnodes[c].length : length;
+		diff = ipnodes[c].prefix ^ prefix;
+		for (common = ipnodes[n].length + 1 ; common < limit ; common++)
+			if (PREFIX_BIT(diff, common))
+				break;
+
+		if (common == ipnodes[c].length)
+		{
+			n = c;
+			continue;
+		}
+
+		// split the edge to the child where the prefixes part
+		m = SV_AllocIPNode (prefix & PREFIX_MASK(common), common);
+		ipnodes[m].child[PREFIX_BIT(ipnodes[c].prefix, common)] = c;
+		ipnodes[n].child[bit] = m;
+		if (common == length)
+			ipnodes[m].filter = true;
+		else
+		{
+			c = SV_AllocIPNode (prefix, length);
+			ipnodes[c].filter = true;
+			ipnodes[m].child[PREFIX_BIT(prefix, common)] = c;
+		}
+		numipfilters++;
+		return true;
+	}
+}
+
+/*
+=================
+SV_RemoveIPFilter
+
+Only removes a prefix that was added exactly the same way.
+=================
+*/
+static qboolean SV_RemoveIPFilter (unsigned prefix, int length)
+{
+	int		path[34];
+	int		depth, n, p, c;
+
+	depth = 0;
+	n = 0;
+	while (1)
+	{
+		if ((prefix ^ ipnodes[n].prefix) & PREFIX_MASK(ipnodes[n].length))
+			return false;
+		path[depth++] = n;
+		if (ipnodes[n].length >= length)
+			break;
+		n = ipnodes[n].child[PREFIX_BIT(prefix, ipnodes[n].length)];
+		if (!n)
+			return false;
+	}
+	if (ipnodes[n].length != length || !ipnodes[n].filter)
+		return false;
+
+	ipnodes[n].filter = false;
+	numipfilters--;
+
+	// pull out nodes that no longer split anything
+	while (--depth > 0)
+	{
+		n = path[depth];
+		p = path[depth-1];
+		if (ipnodes[n].filter || (ipnodes[n].child[0] && ipnodes[n].child[1]))
+			break;
+		c = ipnodes[n].child[0] ? ipnodes[n].child[0] : ipnodes[n].child[1];
+		ipnodes[p].child[ipnodes[p].child[1] == n] = c;
+		SV_FreeIPNode (n);
+		if (c)
+			break;
+	}
+	return true;
+}
+/*freeze*/
 
 /*
 =================
@@ -122,6 +367,7 @@ SV_FilterPacket
 */
 qboolean SV_FilterPacket (char *from)
 {
+/*freeze
 	int		i;
 	unsigned	in;
 	byte m[4];
@@ -147,6 +393,39 @@ qboolean SV_FilterPacket (char *from)
 			return (int)filterban->value;
 
 	return (int)!filterban->value;
+freeze*/
+	int		i, n;
+	unsigned	in, b;
+	char	*p;
+
+	in = 0;
+	p = from;
+	for (i=0 ; i<4 ; i++)
+	{
+		b = 0;
+		while (*p >= '0' && *p <= '9')
+			b = b*10 + *p++ - '0';
+		in |= (b & 255) << (24 - i*8);
+		if (*p != '.')
+			break;
+		p++;
+	}
+
+	// one step per prefix length at most
+	n = 0;
+	do
+	{
+		if ((in ^ ipnodes[n].prefix) & PREFIX_MASK(ipnodes[n].length))
+			break;
+		if (ipnodes[n].filter)
+			return (int)filterban->value;
+		if (ipnodes[n].length == 32)
+			break;
+		n = ipnodes[n].child[PREFIX_BIT(in, ipnodes[n].length)];
+	} while (n);
+
+	return (int)!filterban->value;
+/*freeze*/
 }
 
 
@@ -157,6 +436,7 @@ SV_AddIP_f
 */
 void SVCmd_AddIP_f (void)
 {
+/*freeze
 	int		i;
 	
 	if (gi.argc() < 3) {
@@ -179,6 +459,24 @@ void SVCmd_AddIP_f (void)
 	
 	if (!StringToFilter (gi.argv(2), &ipfilters[i]))
 		ipfilters[i].compare = 0xffffffff;
+freeze*/
+	unsigned	prefix;
+	int			length;
+
+	if (gi.argc() < 3) {
+		gi.cprintf(NULL, PRINT_HIGH, "Usage:  addip <ip-mask>\n");
+		return;
+	}
+
+	if (numipfilters >= maxipfilters->value)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "IP filter list is full\n");
+		return;
+	}
+
+	if (StringToFilter (gi.argv(2), &prefix, &length))
+		SV_AddIPFilter (prefix, length);
+/*freeze*/
 }
 
 /*
@@ -188,6 +486,7 @@ SV_RemoveIP_f
 */
 void SVCmd_RemoveIP_f (void)
 {
+/*freeze
 	ipfilter_t	f;
 	int			i, j;
 
@@ -210,7 +509,63 @@ void SVCmd_RemoveIP_f (void)
 			return;
 		}
 	gi.cprintf (NULL, PRINT_HIGH, "Didn't find %s.\n", gi.argv(2));
+freeze*/
+	unsigned	prefix;
+	int			length;
+
+	if (gi.argc() < 3) {
+		gi.cprintf(NULL, PRINT_HIGH, "Usage:  sv removeip <ip-mask>\n");
+		return;
+	}
+
+	if (!StringToFilter (gi.argv(2), &prefix, &length))
+		return;
+
+	if (SV_RemoveIPFilter (prefix, length))
+		gi.cprintf (NULL, PRINT_HIGH, "Removed.\n");
+	else
+		gi.cprintf (NULL, PRINT_HIGH, "Didn't find %s.\n", gi.argv(2));
+/*freeze*/
+}
+
+/*freeze*/
+// calls func for every filter, lowest address first
+static void SV_WalkIPFilters (int n, void (*func) (ipnode_t *node, void *arg), void *arg)
+{
+	if (ipnodes[n].filter)
+		func (&ipnodes[n], arg);
+	if (ipnodes[n].child[0])
+		SV_WalkIPFilters (ipnodes[n].child[0], func, arg);
+	if (ipnodes[n].child[1])
+		SV_WalkIPFilters (ipnodes[n].child[1], func, arg);
+}
+
+static void SV_ListIPFilter (ipnode_t *node, void *arg)
+{
+	gi.cprintf (NULL, PRINT_HIGH, "%3i.%3i.%3i.%3i/%i\n", node->prefix >> 24, (node->prefix >> 16) & 255,
+		(node->prefix >> 8) & 255, node->prefix & 255, node->length);
+}
+
+static char *SV_IPFileName (void)
+{
+	static char	name[MAX_OSPATH];
+	cvar_t	*game;
+
+	game = gi.cvar("game", "", 0);
+
+	if (!*game->string)
+		sprintf (name, "%s/listip.cfg", GAMEVERSION);
+	else
+		sprintf (name, "%s/listip.cfg", game->string);
+	return name;
+}
+
+static void SV_WriteIPFilter (ipnode_t *node, void *arg)
+{
+	G_IOBufPrintf (arg, "sv addip %i.%i.%i.%i/%i\n", node->prefix >> 24, (node->prefix >> 16) & 255,
+		(node->prefix >> 8) & 255, node->prefix & 255, node->length);
 }
+/*freeze*/
 
 /*
 =================
@@ -219,6 +574,7 @@ SV_ListIP_f
 */
 void SVCmd_ListIP_f (void)
 {
+/*freeze
 	int		i;
 	byte	b[4];
 
@@ -228,7 +584,19 @@ void SVCmd_ListIP_f (void)
 		*(unsigned *)b = ipfilters[i].compare;
 		gi.cprintf (NULL, PRINT_HIGH, "%3i.%3i.%3i.%3i\n", b[0], b[1], b[2], b[3]);
 	}
+freeze*/
+	gi.cprintf (NULL, PRINT_HIGH, "Filter list:\n");
+	SV_WalkIPFilters (0, SV_ListIPFilter, NULL);
+/*freeze*/
+}
+
+/*freeze*/
+static void SVCmd_WriteIPDone (char *filename, byte *data, int length, void *arg)
+{
+	if (!data)
+		gi.cprintf (NULL, PRINT_HIGH, "Couldn't write %s\n", filename);
 }
+/*freeze*/
 
 /*
 =================
@@ -237,7 +605,12 @@ SV_WriteIP_f
 */
 void SVCmd_WriteIP_f (void)
 {
+/*freeze
 	FILE	*f;
+freeze*/
+	iobuf_t	f;
+/*freeze*/
+/*freeze
 	char	name[MAX_OSPATH];
 	byte	b[4];
 	int		i;
@@ -249,9 +622,15 @@ void SVCmd_WriteIP_f (void)
 		sprintf (name, "%s/listip.cfg", GAMEVERSION);
 	else
 		sprintf (name, "%s/listip.cfg", game->string);
+freeze*/
+	char	*name;
+
+	name = SV_IPFileName ();
+/*freeze*/
 
 	gi.cprintf (NULL, PRINT_HIGH, "Writing %s.\n", name);
 
+/*freeze
 	f = fopen (name, "wb");
 	if (!f)
 	{
@@ -260,15 +639,127 @@ void SVCmd_WriteIP_f (void)
 	}
 	
 	fprintf(f, "set filterban %d\n", (int)filterban->value);
+freeze*/
+	G_InitIOBuf (&f);
+
+	G_IOBufPrintf (&f, "set filterban %d\n", (int)filterban->value);
+/*freeze*/
 
+/*freeze
 	for (i=0 ; i<numipfilters ; i++)
 	{
 		*(unsigned *)b = ipfilters[i].compare;
 		fprintf (f, "sv addip %i.%i.%i.%i\n", b[0], b[1], b[2], b[3]);
 	}
+freeze*/
+	SV_WalkIPFilters (0, SV_WriteIPFilter, &f);
+/*freeze*/
 	
+/*freeze
 	fclose (f);
+freeze*/
+	// the file is written in the background
+	G_WriteFile (name, f.data, f.cursize, SVCmd_WriteIPDone, NULL);
+	G_FreeIOBuf (&f);
+/*freeze*/
+}
+
+/*freeze*/
+/*
+=================
+SV_ReadIP
+
+Bulk loads a file written by writeip.  Only the "sv addip" and
+"set filterban" lines are understood.
+=================
+*/
+void SV_ReadIP (char *name)
+{
+	char	*data, *line, *s, *next;
+	unsigned	prefix;
+	int		length, added, bad;
+
+	if (!name)
+		name = SV_IPFileName ();
+	data = G_LoadFile (name, NULL, NULL);
+	if (!data)
+		return;
+
+	added = bad = 0;
+	for (line = data ; *line ; line = next)
+	{
+		for (next = line ; *next && *next != '\n' ; next++)
+			;
+		if (*next)
+			*next++ = 0;
+
+		s = COM_Parse (&line);
+		if (!Q_stricmp (s, "sv"))
+			s = COM_Parse (&line);
+		if (!Q_stricmp (s, "set"))
+		{
+			s = COM_Parse (&line);
+			if (!Q_stricmp (s, "filterban"))
+				gi.cvar_set ("filterban", COM_Parse (&line));
+			continue;
+		}
+		if (Q_stricmp (s, "addip"))
+			continue;
+
+		if (numipfilters >= maxipfilters->value)
+		{
+			gi.dprintf ("%s: IP filter list is full, raise maxipfilters\n", name);
+			break;
+		}
+		if (StringToFilter (COM_Parse (&line), &prefix, &length))
+			added += SV_AddIPFilter (prefix, length);
+		else
+			bad++;
+	}
+	G_FreeFile (data);
+
+	gi.dprintf ("%i ip filters read from %s", added, name);
+	if (bad)
+		gi.dprintf (", %i bad", bad);
+	gi.dprintf ("\n");
+}
+
+/*
+=================
+SV_ReadIP_f
+=================
+*/
+void SVCmd_ReadIP_f (void)
+{
+	SV_ReadIP (gi.argc() > 2 ? gi.argv(2) : NULL);
+}
+
+/*
+=================
+SV_InitIPFilters
+
+Reads listip.cfg directly when the game starts, which is much faster than
+exec'ing it one addip at a time and isn't limited by the command buffer.
+=================
+*/
+void SV_InitIPFilters (void)
+{
+	maxipfilters = gi.cvar ("maxipfilters", "1024", 0);
+	filterload = gi.cvar ("filterload", "1", 0);
+
+	SV_ClearIPFilters ();
+	if (filterload->value)
+		SV_ReadIP (NULL);
+}
+
+void SV_ShutdownIPFilters (void)
+{
+	if (ipnodes)
+		free (ipnodes);
+	ipnodes = NULL;
+	numipnodes = maxipnodes = 0;
 }
+/*freeze*/
 
 /*
 =================
@@ -294,6 +785,22 @@ void	ServerCommand (void)
 		SVCmd_ListIP_f ();
 	else if (Q_stricmp (cmd, "writeip") == 0)
 		SVCmd_WriteIP_f ();
+/*freeze*/
+	else if (Q_stricmp (cmd, "readip") == 0)
+		SVCmd_ReadIP_f ();
+	else if (Q_stricmp (cmd, "prof") == 0)
+		SVCmd_Prof_f ();
+	else if (Q_stricmp (cmd, "bsp") == 0)
+		SVCmd_Bsp_f ();
+	else if (Q_stricmp (cmd, "vecbench") == 0)
+		SVCmd_VecBench_f ();
+	else if (Q_stricmp (cmd, "mem") == 0)
+		SVCmd_Mem_f ();
+	else if (Q_stricmp (cmd, "record") == 0)
+		SVCmd_Record_f ();
+	else if (Q_stricmp (cmd, "replay") == 0)
+		SVCmd_Replay_f ();
+/*freeze*/
 	else
 		gi.cprintf (NULL, PRINT_HIGH, "Unknown server command \"%s\"\n", cmd);
 }
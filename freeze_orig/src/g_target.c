@@ -492,6 +492,71 @@ When triggered, fires a laser.  You can either set a target
 or a direction.
 */
 
+/*freeze*/
+/*
+=================
+LaserTrace
+
+The first segment of a beam usually ends on the world in the same place
+every frame.  Where it did is kept in the laser's moveinfo, which lasers
+don't otherwise use: start_origin and start_angles are the origin and
+movedir it was traced from, end_origin and end_angles the endpoint and
+plane normal, and state is set while they are good.  Until the laser
+turns or moves it only has to check that nothing solid has come into the
+box around the beam.  Doors and other movers are in that box like
+anything else, so they never go stale in here.
+=================
+*/
+static trace_t LaserTrace (edict_t *self, vec3_t start, vec3_t end, edict_t *ignore)
+{
+	trace_t		tr;
+	edict_t		*touch[MAX_EDICTS];
+	vec3_t		mins, maxs;
+	int			i;
+
+	if (ignore == self && self->moveinfo.state
+		&& VectorCompare (self->s.origin, self->moveinfo.start_origin)
+		&& VectorCompare (self->movedir, self->moveinfo.start_angles))
+	{
+		for (i=0 ; i<3 ; i++)
+		{
+			if (start[i] < self->moveinfo.end_origin[i])
+			{
+				mins[i] = start[i];
+				maxs[i] = self->moveinfo.end_origin[i];
+			}
+			else
+			{
+				mins[i] = self->moveinfo.end_origin[i];
+				maxs[i] = start[i];
+			}
+		}
+		if (!gi.BoxEdicts (mins, maxs, touch, MAX_EDICTS, AREA_SOLID))
+		{
+			memset (&tr, 0, sizeof(tr));
+			tr.fraction = self->moveinfo.distance;
+			VectorCopy (self->moveinfo.end_origin, tr.endpos);
+			VectorCopy (self->moveinfo.end_angles, tr.plane.normal);
+			tr.ent = g_edicts;
+			return tr;
+		}
+	}
+
+	tr = gi.trace (start, NULL, NULL, end, ignore, CONTENTS_SOLID|CONTENTS_MONSTER|CONTENTS_DEADMONSTER);
+
+	if (ignore == self)
+	{
+		self->moveinfo.state = (tr.ent == g_edicts);
+		VectorCopy (self->s.origin, self->moveinfo.start_origin);
+		VectorCopy (self->movedir, self->moveinfo.start_angles);
+		VectorCopy (tr.endpos, self->moveinfo.end_origin);
+		VectorCopy (tr.plane.normal, self->moveinfo.end_angles);
+		self->moveinfo.distance = tr.fraction;
+	}
+	return tr;
+}
+/*freeze*/
+
 void target_laser_think (edict_t *self)
 {
 	edict_t	*ignore;
@@ -522,7 +587,11 @@ void target_laser_think (edict_t *self)
 	VectorMA (start, 2048, self->movedir, end);
 	while(1)
 	{
+/*freeze
 		tr = gi.trace (start, NULL, NULL, end, ignore, CONTENTS_SOLID|CONTENTS_MONSTER|CONTENTS_DEADMONSTER);
+freeze*/
+		tr = LaserTrace (self, start, end, ignore);
+/*freeze*/
 
 		if (!tr.ent)
 			break;
@@ -554,7 +623,11 @@ void target_laser_think (edict_t *self)
 
 	VectorCopy (tr.endpos, self->s.old_origin);
 
+/*freeze
 	self->nextthink = level.time + FRAMETIME;
+freeze*/
+	self->nextthink = level.time + BASETIME;
+/*freeze*/
 }
 
 void target_laser_on (edict_t *self)
@@ -0,0 +1,230 @@
+// g_thread.c -- minimal portable threads, mutexes and condition variables
+
+#include "g_local.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/*
+==============================================================================
+
+Worker threads may never call into gi.*, the engine is not thread safe.
+Everything allocated here comes from malloc, not TagMalloc, for the same
+reason.
+
+==============================================================================
+*/
+
+struct gmutex_s
+{
+#ifdef _WIN32
+	CRITICAL_SECTION	cs;
+#else
+	pthread_mutex_t		m;
+#endif
+};
+
+struct gcond_s
+{
+#ifdef _WIN32
+	CONDITION_VARIABLE	cv;
+#else
+	pthread_cond_t		c;
+#endif
+};
+
+struct gthread_s
+{
+#ifdef _WIN32
+	HANDLE		handle;
+#else
+	pthread_t	handle;
+#endif
+	void		(*func) (void *arg);
+	void		*arg;
+};
+
+gmutex_t *G_CreateMutex (void)
+{
+	gmutex_t	*m;
+
+	m = malloc (sizeof(*m));
+	if (!m)
+		gi.error ("G_CreateMutex: out of memory");
+#ifdef _WIN32
+	InitializeCriticalSection (&m->cs);
+#else
+	pthread_mutex_init (&m->m, NULL);
+#endif
+	return m;
+}
+
+void G_DestroyMutex (gmutex_t *m)
+{
+	if (!m)
+		return;
+#ifdef _WIN32
+	DeleteCriticalSection (&m->cs);
+#else
+	pthread_mutex_destroy (&m->m);
+#endif
+	free (m);
+}
+
+void G_LockMutex (gmutex_t *m)
+{
+#ifdef _WIN32
+	EnterCriticalSection (&m->cs);
+#else
+	pthread_mutex_lock (&m->m);
+#endif
+}
+
+void G_UnlockMutex (gmutex_t *m)
+{
+#ifdef _WIN32
+	LeaveCriticalSection (&m->cs);
+#else
+	pthread_mutex_unlock (&m->m);
+#endif
+}
+
+gcond_t *G_CreateCond (void)
+{
+	gcond_t	*c;
+
+	c = malloc (sizeof(*c));
+	if (!c)
+		gi.error ("G_CreateCond: out of memory");
+#ifdef _WIN32
+	InitializeConditionVariable (&c->cv);
+#else
+	pthread_cond_init (&c->c, NULL);
+#endif
+	return c;
+}
+
+void G_DestroyCond (gcond_t *c)
+{
+	if (!c)
+		return;
+#ifndef _WIN32
+	pthread_cond_destroy (&c->c);
+#endif
+	free (c);
+}
+
+/*
+=================
+G_WaitCond
+
+The mutex must be held, it is released while waiting and held again on return.
+Spurious wakeups are possible, so always wait in a loop on the real condition.
+=================
+*/
+void G_WaitCond (gcond_t *c, gmutex_t *m)
+{
+#ifdef _WIN32
+	SleepConditionVariableCS (&c->cv, &m->cs, INFINITE);
+#else
+	pthread_cond_wait (&c->c, &m->m);
+#endif
+}
+
+void G_SignalCond (gcond_t *c)
+{
+#ifdef _WIN32
+	WakeConditionVariable (&c->cv);
+#else
+	pthread_cond_signal (&c->c);
+#endif
+}
+
+void G_BroadcastCond (gcond_t *c)
+{
+#ifdef _WIN32
+	WakeAllConditionVariable (&c->cv);
+#else
+	pthread_cond_broadcast (&c->c);
+#endif
+}
+
+#ifdef _WIN32
+static unsigned __stdcall G_ThreadMain (void *arg)
+#else
+static void *G_ThreadMain (void *arg)
+#endif
+{
+	gthread_t	*t = arg;
+
+	t->func (t->arg);
+	return 0;
+}
+
+/*
+=================
+G_CreateThread
+
+Returns NULL if the thread could not be started, callers should fall
+back to doing the work on the game thread.
+=================
+*/
+gthread_t *G_CreateThread (void (*func) (void *arg), void *arg)
+{
+	gthread_t	*t;
+
+	t = malloc (sizeof(*t));
+	if (!t)
+		return NULL;
+	t->func = func;
+	t->arg = arg;
+#ifdef _WIN32
+	t->handle = (HANDLE)_beginthreadex (NULL, 0, G_ThreadMain, t, 0, NULL);
+	if (!t->handle)
+	{
+		free (t);
+		return NULL;
+	}
+#else
+	if (pthread_create (&t->handle, NULL, G_ThreadMain, t))
+	{
+		free (t);
+		return NULL;
+	}
+#endif
+	return t;
+}
+
+void G_JoinThread (gthread_t *t)
+{
+	if (!t)
+		return;
+#ifdef _WIN32
+	WaitForSingleObject (t->handle, INFINITE);
+	CloseHandle (t->handle);
+#else
+	pthread_join (t->handle, NULL);
+#endif
+	free (t);
+}
+
+int G_NumProcessors (void)
+{
+#ifdef _WIN32
+	SYSTEM_INFO	info;
+
+	GetSystemInfo (&info);
+	return info.dwNumberOfProcessors;
+#else
+	long	n;
+
+	n = sysconf (_SC_NPROCESSORS_ONLN);
+	return n < 1 ? 1 : n;
+#endif
+}
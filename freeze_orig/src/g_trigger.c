@@ -482,11 +482,19 @@ void hurt_touch (edict_t *self, edict_t *other, cplane_t *plane, csurface_t *sur
 	if (self->spawnflags & 16)
 		self->timestamp = level.time + 1;
 	else
+/*freeze
 		self->timestamp = level.time + FRAMETIME;
 
 	if (!(self->spawnflags & 4))
 	{
 		if ((level.framenum % 10) == 0)
+freeze*/
+		self->timestamp = level.time + BASETIME;
+
+	if (!(self->spawnflags & 4))
+	{
+		if ((level.framenum % BASEFRAMES(10)) == 0)
+/*freeze*/
 			gi.sound (other, CHAN_AUTO, self->noise_index, 1, ATTN_NORM, 0);
 	}
 
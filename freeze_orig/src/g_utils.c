@@ -53,12 +53,31 @@ edict_t *G_Find (edict_t *from, int fieldofs, char *match)
 
 	for ( ; from < &g_edicts[globals.num_edicts] ; from++)
 	{
+/*freeze
 		if (!from->inuse)
 			continue;
+freeze*/
+		if (!g_hot.inuse[from - g_edicts])
+			continue;
+		if (fieldofs == FOFS(classname) && g_hot.linked[from - g_edicts])
+		{
+			// only look at the edict once the copy matches, the copy can
+			// be behind for an entity that hasn't been linked since its
+			// spawn function named it
+			s = g_hot.classname[from - g_edicts];
+			if (!s || (s != match && Q_stricmp (s, match)))
+				continue;
+		}
+/*freeze*/
 		s = *(char **) ((byte *)from + fieldofs);
 		if (!s)
 			continue;
+/*freeze
 		if (!Q_stricmp (s, match))
+freeze*/
+		// map strings are interned, so most matches are the same pointer
+		if (s == match || !Q_stricmp (s, match))
+/*freeze*/
 			return from;
 	}
 
@@ -66,6 +85,20 @@ edict_t *G_Find (edict_t *from, int fieldofs, char *match)
 }
 
 
+/*freeze*/
+#define	FINDRADIUS_BLOCK	32
+
+// the last block of box distances, kept for the next findradius call
+// around the same point as long as nothing has been linked or freed
+static struct
+{
+	vec3_t	org;
+	int		serial;
+	int		base, count;
+	float	dist[FINDRADIUS_BLOCK];
+} fr;
+/*freeze*/
+
 /*
 =================
 findradius
@@ -79,15 +112,45 @@ edict_t *findradius (edict_t *from, vec3_t org, float rad)
 {
 	vec3_t	eorg;
 	int		j;
+/*freeze*/
+	int		n, k;
+/*freeze*/
 
+/*freeze*/
+	if (fr.serial != g_hot.serial || !VectorCompare (fr.org, org))
+		fr.count = 0;
+/*freeze*/
 	if (!from)
 		from = g_edicts;
 	else
 		from++;
 	for ( ; from < &g_edicts[globals.num_edicts]; from++)
 	{
+/*freeze
 		if (!from->inuse)
 			continue;
+freeze*/
+		n = from - g_edicts;
+		k = n - fr.base;
+		if (k < 0 || k >= fr.count)
+		{
+			// distances to the boxes of the next few entities at once
+			VectorCopy (org, fr.org);
+			fr.serial = g_hot.serial;
+			fr.base = n;
+			fr.count = globals.num_edicts - n;
+			if (fr.count > FINDRADIUS_BLOCK)
+				fr.count = FINDRADIUS_BLOCK;
+			G_BoxDistances (org, g_hot.absmin + n, g_hot.absmax + n, fr.count, fr.dist);
+			k = 0;
+		}
+		if (!g_hot.inuse[n])
+			continue;
+		// the center is inside the linked box, so if the box
+		// is out of range the center is too
+		if (g_hot.linked[n] && fr.dist[k] > rad * rad)
+			continue;
+/*freeze*/
 		if (from->solid == SOLID_NOT)
 			continue;
 		for (j=0 ; j<3 ; j++)
@@ -392,7 +455,12 @@ char *G_CopyString (char *in)
 {
 	char	*out;
 	
+/*freeze
 	out = gi.TagMalloc (strlen(in)+1, TAG_LEVEL);
+freeze*/
+	// not interned, the caller may write to it
+	out = G_ArenaAlloc (strlen(in)+1);
+/*freeze*/
 	strcpy (out, in);
 	return out;
 }
@@ -404,6 +472,9 @@ void G_InitEdict (edict_t *e)
 	e->classname = "noclass";
 	e->gravity = 1.0;
 	e->s.number = e - g_edicts;
+/*freeze*/
+	G_SyncHot (e);
+/*freeze*/
 }
 
 /*
@@ -427,7 +498,11 @@ edict_t *G_Spawn (void)
 	{
 		// the first couple seconds of server time can involve a lot of
 		// freeing and allocating, so relax the replacement policy
+/*freeze
 		if (!e->inuse && ( e->freetime < 2 || level.time - e->freetime > 0.5 ) )
+freeze*/
+		if (!g_hot.inuse[i] && ( g_hot.freetime[i] < 2 || level.time - g_hot.freetime[i] > 0.5 ) )
+/*freeze*/
 		{
 			G_InitEdict (e);
 			return e;
@@ -463,6 +538,9 @@ void G_FreeEdict (edict_t *ed)
 	ed->classname = "freed";
 	ed->freetime = level.time;
 	ed->inuse = false;
+/*freeze*/
+	G_SyncHot (ed);
+/*freeze*/
 }
 
 
@@ -0,0 +1,515 @@
+// g_vec.c -- vector math over whole arrays, with simd versions
+
+#include "g_local.h"
+
+/*
+==============================================================================
+
+The loops that measure every entity or every player against one point go
+through these instead of a VectorLength per entity.  Each has a plain C
+version and SSE2, AVX and NEON versions where the compiler can build
+them, and G_InitVec picks the best one the processor has.
+
+All of them do the same float operations in the same order as the C
+versions, so they give exactly the same answers and the choice never
+changes the game.  Distances are squared, compare them with the radius
+squared or take the square root of the one that wins.
+
+The arrays are plain vec3_t arrays, the simd versions unpack them four or
+eight at a time.  Set vec_simd 0 to use the C versions, and
+"sv vecbench" to time one against the other.
+
+==============================================================================
+*/
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define	VEC_SSE2
+#include <emmintrin.h>
+#if defined _MSC_VER || defined __GNUC__
+#define	VEC_AVX
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+#elif defined __ARM_NEON || defined __ARM_NEON__
+#define	VEC_NEON
+#include <arm_neon.h>
+#endif
+
+#if defined VEC_AVX && defined __GNUC__
+#define	AVX_FUNC	__attribute__((target("avx")))
+#else
+#define	AVX_FUNC
+#endif
+
+typedef struct
+{
+	char	*name;
+	void	(*pointdistances) (vec3_t point, vec3_t *origins, int count, float *out);
+	void	(*boxdistances) (vec3_t point, vec3_t *mins, vec3_t *maxs, int count, float *out);
+	void	(*dotproducts) (vec3_t v, vec3_t *vecs, int count, float *out);
+} veckernels_t;
+
+cvar_t	*vec_simd;
+
+/*
+==============================================================================
+
+C
+
+==============================================================================
+*/
+
+static void V_PointDistances_C (vec3_t point, vec3_t *origins, int count, float *out)
+{
+	int		i;
+	vec3_t	d;
+
+	for (i=0 ; i<count ; i++)
+	{
+		VectorSubtract (origins[i], point, d);
+		out[i] = DotProduct (d, d);
+	}
+}
+
+static void V_BoxDistances_C (vec3_t point, vec3_t *mins, vec3_t *maxs, int count, float *out)
+{
+	int		i, j;
+	vec3_t	d;
+
+	for (i=0 ; i<count ; i++)
+	{
+		for (j=0 ; j<3 ; j++)
+		{
+			if (point[j] < mins[i][j])
+				d[j] = mins[i][j] - point[j];
+			else if (point[j] > maxs[i][j])
+				d[j] = point[j] - maxs[i][j];
+			else
+				d[j] = 0;
+		}
+		out[i] = DotProduct (d, d);
+	}
+}
+
+static void V_DotProducts_C (vec3_t v, vec3_t *vecs, int count, float *out)
+{
+	int		i;
+
+	for (i=0 ; i<count ; i++)
+		out[i] = DotProduct (v, vecs[i]);
+}
+
+static veckernels_t	vec_c = {"C", V_PointDistances_C, V_BoxDistances_C, V_DotProducts_C};
+
+/*
+==============================================================================
+
+SSE2
+
+==============================================================================
+*/
+
+#ifdef VEC_SSE2
+
+#define	SHUF(a,b,i0,i1,i2,i3)	_mm_shuffle_ps (a, b, _MM_SHUFFLE(i3,i2,i1,i0))
+
+// four vec3_t from p into x, y and z
+#define	LOAD4(p,x,y,z)													\
+{																		\
+	__m128	a_, b_, c_;													\
+	a_ = _mm_loadu_ps (p);				/* x0 y0 z0 x1 */				\
+	b_ = _mm_loadu_ps ((p) + 4);		/* y1 z1 x2 y2 */				\
+	c_ = _mm_loadu_ps ((p) + 8);		/* z2 x3 y3 z3 */				\
+	x = SHUF (a_, SHUF (b_, c_, 2, 2, 1, 1), 0, 3, 0, 2);				\
+	y = SHUF (SHUF (a_, b_, 1, 1, 0, 0), SHUF (b_, c_, 3, 3, 2, 2), 0, 2, 0, 2);	\
+	z = SHUF (SHUF (a_, b_, 2, 2, 1, 1), SHUF (c_, c_, 0, 0, 3, 3), 0, 2, 0, 2);	\
+}
+
+static void V_PointDistances_SSE2 (vec3_t point, vec3_t *origins, int count, float *out)
+{
+	__m128	px, py, pz, x, y, z;
+	int		i;
+
+	px = _mm_set1_ps (point[0]);
+	py = _mm_set1_ps (point[1]);
+	pz = _mm_set1_ps (point[2]);
+	for (i=0 ; i+4<=count ; i+=4)
+	{
+		LOAD4 (origins[i], x, y, z);
+		x = _mm_sub_ps (x, px);
+		y = _mm_sub_ps (y, py);
+		z = _mm_sub_ps (z, pz);
+		x = _mm_add_ps (_mm_add_ps (_mm_mul_ps (x, x), _mm_mul_ps (y, y)), _mm_mul_ps (z, z));
+		_mm_storeu_ps (out + i, x);
+	}
+	V_PointDistances_C (point, origins + i, count - i, out + i);
+}
+
+static void V_BoxDistances_SSE2 (vec3_t point, vec3_t *mins, vec3_t *maxs, int count, float *out)
+{
+	__m128	px, py, pz, x, y, z, x2, y2, z2, zero;
+	int		i;
+
+	px = _mm_set1_ps (point[0]);
+	py = _mm_set1_ps (point[1]);
+	pz = _mm_set1_ps (point[2]);
+	zero = _mm_setzero_ps ();
+	for (i=0 ; i+4<=count ; i+=4)
+	{
+		LOAD4 (mins[i], x, y, z);
+		LOAD4 (maxs[i], x2, y2, z2);
+		x = _mm_max_ps (_mm_max_ps (_mm_sub_ps (x, px), _mm_sub_ps (px, x2)), zero);
+		y = _mm_max_ps (_mm_max_ps (_mm_sub_ps (y, py), _mm_sub_ps (py, y2)), zero);
+		z = _mm_max_ps (_mm_max_ps (_mm_sub_ps (z, pz), _mm_sub_ps (pz, z2)), zero);
+		x = _mm_add_ps (_mm_add_ps (_mm_mul_ps (x, x), _mm_mul_ps (y, y)), _mm_mul_ps (z, z));
+		_mm_storeu_ps (out + i, x);
+	}
+	V_BoxDistances_C (point, mins + i, maxs + i, count - i, out + i);
+}
+
+static void V_DotProducts_SSE2 (vec3_t v, vec3_t *vecs, int count, float *out)
+{
+	__m128	vx, vy, vz, x, y, z;
+	int		i;
+
+	vx = _mm_set1_ps (v[0]);
+	vy = _mm_set1_ps (v[1]);
+	vz = _mm_set1_ps (v[2]);
+	for (i=0 ; i+4<=count ; i+=4)
+	{
+		LOAD4 (vecs[i], x, y, z);
+		x = _mm_add_ps (_mm_add_ps (_mm_mul_ps (vx, x), _mm_mul_ps (vy, y)), _mm_mul_ps (vz, z));
+		_mm_storeu_ps (out + i, x);
+	}
+	V_DotProducts_C (v, vecs + i, count - i, out + i);
+}
+
+static veckernels_t	vec_sse2 = {"SSE2", V_PointDistances_SSE2, V_BoxDistances_SSE2, V_DotProducts_SSE2};
+
+#endif	// VEC_SSE2
+
+/*
+==============================================================================
+
+AVX
+
+Only called once G_InitVec has seen the processor has it.
+
+==============================================================================
+*/
+
+#ifdef VEC_AVX
+
+// two LOAD4s, gathers are slower than shuffles on most processors
+#define	LOAD8(p,x,y,z)											\
+{																\
+	__m128	xl_, yl_, zl_, xh_, yh_, zh_;						\
+	LOAD4 ((p), xl_, yl_, zl_);									\
+	LOAD4 ((p) + 12, xh_, yh_, zh_);							\
+	x = _mm256_set_m128 (xh_, xl_);								\
+	y = _mm256_set_m128 (yh_, yl_);								\
+	z = _mm256_set_m128 (zh_, zl_);								\
+}
+
+AVX_FUNC static void V_PointDistances_AVX (vec3_t point, vec3_t *origins, int count, float *out)
+{
+	__m256	px, py, pz, x, y, z;
+	int		i;
+
+	px = _mm256_set1_ps (point[0]);
+	py = _mm256_set1_ps (point[1]);
+	pz = _mm256_set1_ps (point[2]);
+	for (i=0 ; i+8<=count ; i+=8)
+	{
+		LOAD8 (origins[i], x, y, z);
+		x = _mm256_sub_ps (x, px);
+		y = _mm256_sub_ps (y, py);
+		z = _mm256_sub_ps (z, pz);
+		x = _mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (x, x), _mm256_mul_ps (y, y)), _mm256_mul_ps (z, z));
+		_mm256_storeu_ps (out + i, x);
+	}
+	_mm256_zeroupper ();	// the sse2 code would stall on the dirty upper halves
+	V_PointDistances_SSE2 (point, origins + i, count - i, out + i);
+}
+
+AVX_FUNC static void V_BoxDistances_AVX (vec3_t point, vec3_t *mins, vec3_t *maxs, int count, float *out)
+{
+	__m256	px, py, pz, x, y, z, x2, y2, z2, zero;
+	int		i;
+
+	px = _mm256_set1_ps (point[0]);
+	py = _mm256_set1_ps (point[1]);
+	pz = _mm256_set1_ps (point[2]);
+	zero = _mm256_setzero_ps ();
+	for (i=0 ; i+8<=count ; i+=8)
+	{
+		LOAD8 (mins[i], x, y, z);
+		LOAD8 (maxs[i], x2, y2, z2);
+		x = _mm256_max_ps (_mm256_max_ps (_mm256_sub_ps (x, px), _mm256_sub_ps (px, x2)), zero);
+		y = _mm256_max_ps (_mm256_max_ps (_mm256_sub_ps (y, py), _mm256_sub_ps (py, y2)), zero);
+		z = _mm256_max_ps (_mm256_max_ps (_mm256_sub_ps (z, pz), _mm256_sub_ps (pz, z2)), zero);
+		x = _mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (x, x), _mm256_mul_ps (y, y)), _mm256_mul_ps (z, z));
+		_mm256_storeu_ps (out + i, x);
+	}
+	_mm256_zeroupper ();	// the sse2 code would stall on the dirty upper halves
+	V_BoxDistances_SSE2 (point, mins + i, maxs + i, count - i, out + i);
+}
+
+AVX_FUNC static void V_DotProducts_AVX (vec3_t v, vec3_t *vecs, int count, float *out)
+{
+	__m256	vx, vy, vz, x, y, z;
+	int		i;
+
+	vx = _mm256_set1_ps (v[0]);
+	vy = _mm256_set1_ps (v[1]);
+	vz = _mm256_set1_ps (v[2]);
+	for (i=0 ; i+8<=count ; i+=8)
+	{
+		LOAD8 (vecs[i], x, y, z);
+		x = _mm256_add_ps (_mm256_add_ps (_mm256_mul_ps (vx, x), _mm256_mul_ps (vy, y)), _mm256_mul_ps (vz, z));
+		_mm256_storeu_ps (out + i, x);
+	}
+	_mm256_zeroupper ();	// the sse2 code would stall on the dirty upper halves
+	V_DotProducts_SSE2 (v, vecs + i, count - i, out + i);
+}
+
+static veckernels_t	vec_avx = {"AVX", V_PointDistances_AVX, V_BoxDistances_AVX, V_DotProducts_AVX};
+
+static qboolean V_HaveAVX (void)
+{
+#ifdef _MSC_VER
+	int		regs[4];
+
+	__cpuid (regs, 1);
+	if ((regs[2] & (1<<27 | 1<<28)) != (1<<27 | 1<<28))
+		return false;		// no avx, or the os doesn't save the registers
+	return (_xgetbv (0) & 6) == 6;
+#else
+	__builtin_cpu_init ();
+	return __builtin_cpu_supports ("avx");
+#endif
+}
+
+#endif	// VEC_AVX
+
+/*
+==============================================================================
+
+NEON
+
+==============================================================================
+*/
+
+#ifdef VEC_NEON
+
+static void V_PointDistances_NEON (vec3_t point, vec3_t *origins, int count, float *out)
+{
+	float32x4x3_t	o;
+	float32x4_t		px, py, pz, x, y, z;
+	int				i;
+
+	px = vdupq_n_f32 (point[0]);
+	py = vdupq_n_f32 (point[1]);
+	pz = vdupq_n_f32 (point[2]);
+	for (i=0 ; i+4<=count ; i+=4)
+	{
+		o = vld3q_f32 (origins[i]);
+		x = vsubq_f32 (o.val[0], px);
+		y = vsubq_f32 (o.val[1], py);
+		z = vsubq_f32 (o.val[2], pz);
+		x = vaddq_f32 (vaddq_f32 (vmulq_f32 (x, x), vmulq_f32 (y, y)), vmulq_f32 (z, z));
+		vst1q_f32 (out + i, x);
+	}
+	V_PointDistances_C (point, origins + i, count - i, out + i);
+}
+
+static void V_BoxDistances_NEON (vec3_t point, vec3_t *mins, vec3_t *maxs, int count, float *out)
+{
+	float32x4x3_t	mn, mx;
+	float32x4_t		px, py, pz, x, y, z, zero;
+	int				i;
+
+	px = vdupq_n_f32 (point[0]);
+	py = vdupq_n_f32 (point[1]);
+	pz = vdupq_n_f32 (point[2]);
+	zero = vdupq_n_f32 (0);
+	for (i=0 ; i+4<=count ; i+=4)
+	{
+		mn = vld3q_f32 (mins[i]);
+		mx = vld3q_f32 (maxs[i]);
+		x = vmaxq_f32 (vmaxq_f32 (vsubq_f32 (mn.val[0], px), vsubq_f32 (px, mx.val[0])), zero);
+		y = vmaxq_f32 (vmaxq_f32 (vsubq_f32 (mn.val[1], py), vsubq_f32 (py, mx.val[1])), zero);
+		z = vmaxq_f32 (vmaxq_f32 (vsubq_f32 (mn.val[2], pz), vsubq_f32 (pz, mx.val[2])), zero);
+		x = vaddq_f32 (vaddq_f32 (vmulq_f32 (x, x), vmulq_f32 (y, y)), vmulq_f32 (z, z));
+		vst1q_f32 (out + i, x);
+	}
+	V_BoxDistances_C (point, mins + i, maxs + i, count - i, out + i);
+}
+
+static void V_DotProducts_NEON (vec3_t v, vec3_t *vecs, int count, float *out)
+{
+	float32x4x3_t	o;
+	float32x4_t		vx, vy, vz, x;
+	int				i;
+
+	vx = vdupq_n_f32 (v[0]);
+	vy = vdupq_n_f32 (v[1]);
+	vz = vdupq_n_f32 (v[2]);
+	for (i=0 ; i+4<=count ; i+=4)
+	{
+		o = vld3q_f32 (vecs[i]);
+		x = vaddq_f32 (vaddq_f32 (vmulq_f32 (vx, o.val[0]), vmulq_f32 (vy, o.val[1])), vmulq_f32 (vz, o.val[2]));
+		vst1q_f32 (out + i, x);
+	}
+	V_DotProducts_C (v, vecs + i, count - i, out + i);
+}
+
+static veckernels_t	vec_neon = {"NEON", V_PointDistances_NEON, V_BoxDistances_NEON, V_DotProducts_NEON};
+
+#endif	// VEC_NEON
+
+//============================================================================
+
+static veckernels_t	*vec_kernels = &vec_c;
+
+void (*G_PointDistances) (vec3_t point, vec3_t *origins, int count, float *out) = V_PointDistances_C;
+void (*G_BoxDistances) (vec3_t point, vec3_t *mins, vec3_t *maxs, int count, float *out) = V_BoxDistances_C;
+void (*G_DotProducts) (vec3_t v, vec3_t *vecs, int count, float *out) = V_DotProducts_C;
+
+static veckernels_t *V_BestKernels (void)
+{
+#ifdef VEC_AVX
+	if (V_HaveAVX ())
+		return &vec_avx;
+#endif
+#ifdef VEC_SSE2
+	return &vec_sse2;
+#elif defined VEC_NEON
+	return &vec_neon;
+#else
+	return &vec_c;
+#endif
+}
+
+/*
+=================
+G_InitVec
+=================
+*/
+void G_InitVec (void)
+{
+	vec_simd = gi.cvar ("vec_simd", "1", 0);
+
+	if (vec_simd->value)
+		vec_kernels = V_BestKernels ();
+	else
+		vec_kernels = &vec_c;
+
+	G_PointDistances = vec_kernels->pointdistances;
+	G_BoxDistances = vec_kernels->boxdistances;
+	G_DotProducts = vec_kernels->dotproducts;
+
+	if (vec_kernels != &vec_c)
+		gi.dprintf ("%s vector math\n", vec_kernels->name);
+}
+
+/*
+=================
+SVCmd_VecBench_f
+
+sv vecbench [count]
+
+Times the C and the selected versions over count random vectors and
+checks they agree.
+=================
+*/
+void SVCmd_VecBench_f (void)
+{
+	veckernels_t	*kernels[2];
+	vec3_t			*a, *b, point;
+	float			*out[2];
+	double			start, time[2][3];
+	int				count, reps, i, j, k;
+	qboolean		same;
+
+	count = atoi (gi.argv(2));
+	if (count <= 0)
+		count = 4096;
+	reps = 4000000 / count + 1;
+
+	a = malloc (count * sizeof(vec3_t));
+	b = malloc (count * sizeof(vec3_t));
+	out[0] = malloc (count * sizeof(float));
+	out[1] = malloc (count * sizeof(float));
+	if (!a || !b || !out[0] || !out[1])
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "out of memory\n");
+		goto done;
+	}
+
+	for (i=0 ; i<count ; i++)
+	{
+		for (j=0 ; j<3 ; j++)
+		{
+			a[i][j] = crandom() * 4096;
+			b[i][j] = a[i][j] + random() * 64;
+		}
+	}
+	VectorSet (point, crandom() * 4096, crandom() * 4096, crandom() * 4096);
+
+	kernels[0] = &vec_c;
+	kernels[1] = V_BestKernels ();
+	same = true;
+	for (k=0 ; k<2 ; k++)
+	{
+		start = G_ProfTime ();
+		for (i=0 ; i<reps ; i++)
+			kernels[k]->pointdistances (point, a, count, out[k]);
+		time[k][0] = G_ProfTime () - start;
+
+		start = G_ProfTime ();
+		for (i=0 ; i<reps ; i++)
+			kernels[k]->dotproducts (point, a, count, out[k]);
+		time[k][1] = G_ProfTime () - start;
+
+		start = G_ProfTime ();
+		for (i=0 ; i<reps ; i++)
+			kernels[k]->boxdistances (point, a, b, count, out[k]);
+		time[k][2] = G_ProfTime () - start;
+	}
+
+	// each one again, and compare
+	for (j=0 ; j<3 ; j++)
+	{
+		for (k=0 ; k<2 ; k++)
+		{
+			if (j == 0)
+				kernels[k]->pointdistances (point, a, count, out[k]);
+			else if (j == 1)
+				kernels[k]->dotproducts (point, a, count, out[k]);
+			else
+				kernels[k]->boxdistances (point, a, b, count, out[k]);
+		}
+		if (memcmp (out[0], out[1], count * sizeof(float)))
+			same = false;
+	}
+
+	gi.cprintf (NULL, PRINT_HIGH, "%i vectors, %s against %s%s\n", count, kernels[1]->name,
+		kernels[0]->name, same ? "" : ", RESULTS DIFFER");
+	gi.cprintf (NULL, PRINT_HIGH, "                 ns/vec   ns/vec  speedup\n");
+	for (j=0 ; j<3 ; j++)
+	{
+		gi.cprintf (NULL, PRINT_HIGH, "%-15s %7.3f  %7.3f  %6.2fx\n",
+			j == 0 ? "point distance" : j == 1 ? "dot product" : "box distance",
+			time[0][j] * 1e9 / reps / count, time[1][j] * 1e9 / reps / count,
+			time[1][j] ? time[0][j] / time[1][j] : 0);
+	}
+
+done:
+	free (a);
+	free (b);
+	free (out[0]);
+	free (out[1]);
+}
@@ -162,7 +162,11 @@ static void fire_lead (edict_t *self, vec3_t start, vec3_t aimdir, int damage, i
 			content_mask &= ~MASK_WATER;
 		}
 
+/*freeze
 		tr = gi.trace (start, NULL, NULL, end, self, content_mask);
+freeze*/
+		tr = G_LagTrace (self, start, end, self, content_mask);
+/*freeze*/
 
 		// see if we hit water
 		if (tr.contents & MASK_WATER)
@@ -211,7 +215,11 @@ static void fire_lead (edict_t *self, vec3_t start, vec3_t aimdir, int damage, i
 			}
 
 			// re-trace ignoring water this time
+/*freeze
 			tr = gi.trace (water_start, NULL, NULL, end, self, MASK_SHOT);
+freeze*/
+			tr = G_LagTrace (self, water_start, end, self, MASK_SHOT);
+/*freeze*/
 		}
 	}
 
@@ -671,7 +679,11 @@ void fire_rail (edict_t *self, vec3_t start, vec3_t aimdir, int damage, int kick
 	mask = MASK_SHOT|CONTENTS_SLIME|CONTENTS_LAVA;
 	while (ignore)
 	{
+/*freeze
 		tr = gi.trace (from, NULL, NULL, end, ignore, mask);
+freeze*/
+		tr = G_LagTrace (self, from, end, ignore, mask);
+/*freeze*/
 
 		if (tr.contents & (CONTENTS_SLIME|CONTENTS_LAVA))
 		{
@@ -762,7 +774,11 @@ void bfg_explode (edict_t *self)
 		}
 	}
 
+/*freeze
 	self->nextthink = level.time + FRAMETIME;
+freeze*/
+	self->nextthink = level.time + BASETIME;
+/*freeze*/
 	self->s.frame++;
 	if (self->s.frame == 5)
 		self->think = G_FreeEdict;
@@ -797,7 +813,11 @@ void bfg_touch (edict_t *self, edict_t *other, cplane_t *plane, csurface_t *surf
 	self->s.sound = 0;
 	self->s.effects &= ~EF_ANIM_ALLFAST;
 	self->think = bfg_explode;
+/*freeze
 	self->nextthink = level.time + FRAMETIME;
+freeze*/
+	self->nextthink = level.time + BASETIME;
+/*freeze*/
 	self->enemy = other;
 
 	gi.WriteByte (svc_temp_entity);
@@ -885,7 +905,11 @@ void bfg_think (edict_t *self)
 		gi.multicast (self->s.origin, MULTICAST_PHS);
 	}
 
+/*freeze
 	self->nextthink = level.time + FRAMETIME;
+freeze*/
+	self->nextthink = level.time + BASETIME;
+/*freeze*/
 }
 
 
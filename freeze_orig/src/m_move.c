@@ -282,6 +282,9 @@ qboolean SV_movestep (edict_t *ent, vec3_t move, qboolean relink)
 	}
 	ent->groundentity = trace.ent;
 	ent->groundentity_linkcount = trace.ent->linkcount;
+/*freeze*/
+	G_AddRider (ent);
+/*freeze*/
 
 // the move is ok
 	if (relink)
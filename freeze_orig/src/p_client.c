@@ -222,6 +222,9 @@ void ClientObituary (edict_t *self, edict_t *inflictor, edict_t *attacker)
 	{
 		ff = meansOfDeath & MOD_FRIENDLY_FIRE;
 		mod = meansOfDeath & ~MOD_FRIENDLY_FIRE;
+/*freeze*/
+		G_JournalEvent (JE_FRAG, attacker, self, self->client->resp.team, mod, ff ? 1 : 0);
+/*freeze*/
 		message = NULL;
 		message2 = "";
 
@@ -426,7 +429,11 @@ void TossClientWeapon (edict_t *self)
 	if (!((int)(dmflags->value) & DF_QUAD_DROP))
 		quad = false;
 	else
+/*freeze
 		quad = (self->client->quad_framenum > (level.framenum + 10));
+freeze*/
+		quad = (self->client->quad_framenum > (level.framenum + BASEFRAMES(10)));
+/*freeze*/
 
 	if (item && quad)
 		spread = 22.5;
@@ -539,7 +546,7 @@ void player_die (edict_t *self, edict_t *inflictor, edict_t *attacker, int damag
 			self->client->pers.inventory[n] = 0;
 		}
 /*freeze*/
-		freeze[self->client->resp.team].update = true;
+		arena_of(self)->freeze[self->client->resp.team].update = true;
 /*freeze*/
 	}
 
@@ -553,6 +560,7 @@ void player_die (edict_t *self, edict_t *inflictor, edict_t *attacker, int damag
 /*freeze*/
 	if (freezeCheck(self))
 	{
+		G_JournalEvent (JE_FREEZE, attacker, self, self->client->resp.team, meansOfDeath, 0);
 		freezeAnim(self);
 		return;
 	}
@@ -656,6 +664,9 @@ void InitClientResp (gclient_t *client)
 	int	team = client->resp.team;
 	qboolean	old_hook = client->resp.old_hook;
 	int	help = client->resp.help;
+	int	arena = client->resp.arena;
+
+	freezeVote(client, -1);
 /*freeze*/
 	memset (&client->resp, 0, sizeof(client->resp));
 	client->resp.enterframe = level.framenum;
@@ -665,6 +676,7 @@ void InitClientResp (gclient_t *client)
 	client->resp.old_hook = old_hook;
 	client->resp.help = help;
 	client->resp.vote = -1;
+	client->resp.arena = arena;
 /*freeze*/
 }
 
@@ -726,13 +738,23 @@ float	PlayersRangeFromSpot (edict_t *spot)
 {
 	edict_t	*player;
 	float	bestplayerdistance;
+/*freeze
 	vec3_t	v;
+freeze*/
 	int		n;
 	float	playerdistance;
+/*freeze*/
+	vec3_t	origins[MAX_CLIENTS];
+	float	dist[MAX_CLIENTS];
+	int		count;
+/*freeze*/
 
 
 	bestplayerdistance = 9999999;
 
+/*freeze*/
+	count = 0;
+/*freeze*/
 	for (n = 1; n <= maxclients->value; n++)
 	{
 		player = &g_edicts[n];
@@ -743,13 +765,30 @@ float	PlayersRangeFromSpot (edict_t *spot)
 		if (player->health <= 0)
 			continue;
 
+/*freeze
 		VectorSubtract (spot->s.origin, player->s.origin, v);
 		playerdistance = VectorLength (v);
 
 		if (playerdistance < bestplayerdistance)
 			bestplayerdistance = playerdistance;
+freeze*/
+		VectorCopy (player->s.origin, origins[count]);
+		count++;
 	}
 
+	// compare squared distances, and only take the root of the nearest
+	G_PointDistances (spot->s.origin, origins, count, dist);
+	for (n = 1; n < count; n++)
+		if (dist[n] < dist[0])
+			dist[0] = dist[n];
+	if (count)
+	{
+		playerdistance = sqrt (dist[0]);
+		if (playerdistance < bestplayerdistance)
+			bestplayerdistance = playerdistance;
+	}
+/*freeze*/
+
 	return bestplayerdistance;
 }
 
@@ -761,7 +800,11 @@ go to a random point, but NOT the two points closest
 to other players
 ================
 */
+/*freeze
 edict_t *SelectRandomDeathmatchSpawnPoint (void)
+freeze*/
+edict_t *SelectRandomDeathmatchSpawnPoint (edict_t *ent)
+/*freeze*/
 {
 	edict_t	*spot, *spot1, *spot2;
 	int		count = 0;
@@ -774,6 +817,10 @@ edict_t *SelectRandomDeathmatchSpawnPoint (void)
 
 	while ((spot = G_Find (spot, FOFS(classname), "info_player_deathmatch")) != NULL)
 	{
+/*freeze*/
+		if (!freezeSpot (spot, ent))
+			continue;
+/*freeze*/
 		count++;
 		range = PlayersRangeFromSpot(spot);
 		if (range < range1)
@@ -804,7 +851,11 @@ edict_t *SelectRandomDeathmatchSpawnPoint (void)
 	do
 	{
 		spot = G_Find (spot, FOFS(classname), "info_player_deathmatch");
+/*freeze
 		if (spot == spot1 || spot == spot2)
+freeze*/
+		if (spot == spot1 || spot == spot2 || !freezeSpot (spot, ent))
+/*freeze*/
 			selection++;
 	} while(selection--);
 
@@ -817,7 +868,11 @@ SelectFarthestDeathmatchSpawnPoint
 
 ================
 */
+/*freeze
 edict_t *SelectFarthestDeathmatchSpawnPoint (void)
+freeze*/
+edict_t *SelectFarthestDeathmatchSpawnPoint (edict_t *ent)
+/*freeze*/
 {
 	edict_t	*bestspot;
 	float	bestdistance, bestplayerdistance;
@@ -829,6 +884,10 @@ edict_t *SelectFarthestDeathmatchSpawnPoint (void)
 	bestdistance = 0;
 	while ((spot = G_Find (spot, FOFS(classname), "info_player_deathmatch")) != NULL)
 	{
+/*freeze*/
+		if (!freezeSpot (spot, ent))
+			continue;
+/*freeze*/
 		bestplayerdistance = PlayersRangeFromSpot (spot);
 
 		if (bestplayerdistance > bestdistance)
@@ -845,17 +904,33 @@ edict_t *SelectFarthestDeathmatchSpawnPoint (void)
 
 	// if there is a player just spawned on each and every start spot
 	// we have no choice to turn one into a telefrag meltdown
+/*freeze
 	spot = G_Find (NULL, FOFS(classname), "info_player_deathmatch");
+freeze*/
+	spot = NULL;
+	while ((spot = G_Find (spot, FOFS(classname), "info_player_deathmatch")) != NULL)
+		if (freezeSpot (spot, ent))
+			break;
+/*freeze*/
 
 	return spot;
 }
 
+/*freeze
 edict_t *SelectDeathmatchSpawnPoint (void)
 {
 	if ( (int)(dmflags->value) & DF_SPAWN_FARTHEST)
 		return SelectFarthestDeathmatchSpawnPoint ();
 	else
 		return SelectRandomDeathmatchSpawnPoint ();
+freeze*/
+edict_t *SelectDeathmatchSpawnPoint (edict_t *ent)
+{
+	if ( (int)(dmflags->value) & DF_SPAWN_FARTHEST)
+		return SelectFarthestDeathmatchSpawnPoint (ent);
+	else
+		return SelectRandomDeathmatchSpawnPoint (ent);
+/*freeze*/
 }
 
 
@@ -908,7 +983,16 @@ void	SelectSpawnPoint (edict_t *ent, vec3_t origin, vec3_t angles)
 	edict_t	*spot = NULL;
 
 	if (deathmatch->value)
+/*freeze
 		spot = SelectDeathmatchSpawnPoint ();
+freeze*/
+	{
+		spot = SelectDeathmatchSpawnPoint (ent);
+		// an arena with no spawns of its own
+		if (!spot)
+			spot = SelectDeathmatchSpawnPoint (NULL);
+	}
+/*freeze*/
 	else if (coop->value)
 		spot = SelectCoopSpawnPoint (ent);
 
@@ -1214,6 +1298,9 @@ void PutClientInServer (edict_t *ent)
 	ent->classname = "player";
 	ent->mass = 200;
 	ent->solid = SOLID_BBOX;
+/*freeze*/
+	G_SyncHot (ent);
+/*freeze*/
 	ent->deadflag = DEAD_NO;
 	ent->air_finished = level.time + 12;
 	ent->clipmask = MASK_PLAYERSOLID;
@@ -1281,6 +1368,9 @@ void PutClientInServer (edict_t *ent)
 		client->chase_target = NULL;
 
 		client->resp.spectator = true;
+/*freeze*/
+		G_UpdateChaseable (ent);
+/*freeze*/
 
 		ent->movetype = MOVETYPE_NOCLIP;
 		ent->solid = SOLID_NOT;
@@ -1293,7 +1383,14 @@ void PutClientInServer (edict_t *ent)
 /*freeze*/
 		return;
 	} else
+/*freeze
 		client->resp.spectator = false;
+freeze*/
+	{
+		client->resp.spectator = false;
+		G_UpdateChaseable (ent);
+	}
+/*freeze*/
 
 	if (!KillBox (ent))
 	{	// could't spawn in?
@@ -1307,7 +1404,7 @@ void PutClientInServer (edict_t *ent)
 	ChangeWeapon (ent);
 freeze*/
 	playerWeapon(ent);
-	freeze[ent->client->resp.team].update = true;
+	arena_of(ent)->freeze[ent->client->resp.team].update = true;
 /*freeze*/
 }
 
@@ -1439,6 +1536,10 @@ void ClientUserinfoChanged (edict_t *ent, char *userinfo)
 	// set name
 	s = Info_ValueForKey (userinfo, "name");
 	strncpy (ent->client->pers.netname, s, sizeof(ent->client->pers.netname)-1);
+/*freeze*/
+	G_JournalName (ent);
+	G_EffectRate (ent, userinfo);
+/*freeze*/
 
 	// set spectator
 	s = Info_ValueForKey (userinfo, "spectator");
@@ -1567,6 +1668,7 @@ qboolean ClientConnect (edict_t *ent, char *userinfo)
 		ent->client->resp.help = 0;
 		ent->client->resp.vote = -1;
 		ent->client->resp.thawed = 0;
+		ent->client->resp.arena = freezeArena();
 /*freeze*/
 		InitClientResp (ent->client);
 		if (!game.autosaved || !ent->client->pers.weapon)
@@ -1611,12 +1713,18 @@ void ClientDisconnect (edict_t *ent)
 	ent->solid = SOLID_NOT;
 	ent->inuse = false;
 	ent->classname = "disconnected";
+/*freeze*/
+	G_SyncHot (ent);
+	G_UpdateChaseable (ent);
+/*freeze*/
 	ent->client->pers.connected = false;
 
 	playernum = ent-g_edicts-1;
 	gi.configstring (CS_PLAYERSKINS+playernum, "");
 /*freeze*/
-	freeze[ent->client->resp.team].update = true;
+	arena_of(ent)->freeze[ent->client->resp.team].update = true;
+	freezeVote(ent->client, -1);
+	G_JournalEvent (JE_LEAVE, ent, NULL, ent->client->resp.team, 0, 0);
 /*freeze*/
 }
 
@@ -1759,6 +1867,9 @@ freeze*/
 		ent->groundentity = pm.groundentity;
 		if (pm.groundentity)
 			ent->groundentity_linkcount = pm.groundentity->linkcount;
+/*freeze*/
+		G_AddRider (ent);
+/*freeze*/
 
 /*freeze*/
 		if (ent->deadflag && !ent->client->frozen)
@@ -1883,11 +1994,23 @@ void ClientBeginServerFrame (edict_t *ent)
 		return;
 	}
 
+/*freeze
 	// run weapon animations if it hasn't been done by a ucmd_t
 	if (!client->weapon_thunk && !client->resp.spectator)
 		Think_Weapon (ent);
 	else
 		client->weapon_thunk = false;
+freeze*/
+	// run weapon animations if it hasn't been done by a ucmd_t,
+	// weapons only think every BASETIME whatever the frame rate
+	if (ISBASEFRAME)
+	{
+		if (!client->weapon_thunk && !client->resp.spectator)
+			Think_Weapon (ent);
+		else
+			client->weapon_thunk = false;
+	}
+/*freeze*/
 
 	if (ent->deadflag)
 	{
@@ -247,7 +247,11 @@ void DeathmatchScoreboardMessage (edict_t *ent, edict_t *killer)
 		// send the layout
 		Com_sprintf (entry, sizeof(entry),
 			"client %i %i %i %i %i %i ",
+/*freeze
 			x, y, sorted[i], cl->resp.score, cl->ping, (level.framenum - cl->resp.enterframe)/600);
+freeze*/
+			x, y, sorted[i], cl->resp.score, cl->ping, (level.framenum - cl->resp.enterframe)/BASEFRAMES(600));
+/*freeze*/
 		j = strlen(entry);
 		if (stringlength + j > 1024)
 			break;
@@ -381,6 +385,80 @@ void Cmd_Help_f (edict_t *ent)
 
 //=======================================================================
 
+/*freeze*/
+// the stats that come out the same for every client in an arena, built once a frame
+static short	hud_stats[MAX_ARENAS][MAX_STATS];
+static qboolean	hud_built;		// hud_stats is for this level
+
+// image indices, looked up the first time this level needs them
+static int	hud_itemicons[MAX_ITEMS];
+static int	hud_powershield, hud_quad, hud_invulnerability;
+static int	hud_envirosuit, hud_rebreather, hud_help;
+static int	hud_cells;
+
+static int HudImage (int *cache, char *name)
+{
+	if (!*cache)
+		*cache = gi.imageindex (name);
+	return *cache;
+}
+
+static int HudItemIcon (gitem_t *item)
+{
+	return HudImage (&hud_itemicons[ITEM_INDEX(item)], item->icon);
+}
+
+/*
+===============
+G_ResetHud
+
+Called from SpawnEntities, image indices only last the level.
+===============
+*/
+void G_ResetHud (void)
+{
+	memset (hud_stats, 0, sizeof(hud_stats));
+	hud_built = false;
+	memset (hud_itemicons, 0, sizeof(hud_itemicons));
+	hud_powershield = hud_quad = hud_invulnerability = 0;
+	hud_envirosuit = hud_rebreather = hud_help = 0;
+}
+
+/*
+===============
+G_HudFrame
+
+Called before the client frames are ended, G_SetStats copies from it.
+===============
+*/
+void G_HudFrame (void)
+{
+	int		i;
+
+	memset (hud_stats, 0, sizeof(hud_stats));
+	for (i=0 ; i<numarenas ; i++)
+	{
+		hud_stats[i][STAT_HEALTH_ICON] = level.pic_health;
+		teamStats (hud_stats[i], i);
+	}
+	hud_built = true;
+}
+
+/*
+===============
+G_CheckHud
+
+For a client frame ended on its own, a client can begin before the
+new level has run a frame and must not get the last level's stats.
+===============
+*/
+void G_CheckHud (void)
+{
+	if (!hud_built)
+		G_HudFrame ();
+}
+/*freeze*/
+
 /*
 ===============
 G_SetStats
@@ -395,7 +473,11 @@ void G_SetStats (edict_t *ent)
 	//
 	// health
 	//
+/*freeze
 	ent->client->ps.stats[STAT_HEALTH_ICON] = level.pic_health;
+freeze*/
+	ent->client->ps.stats[STAT_HEALTH_ICON] = hud_stats[ent->client->resp.arena][STAT_HEALTH_ICON];
+/*freeze*/
 	ent->client->ps.stats[STAT_HEALTH] = ent->health;
 
 	//
@@ -409,7 +491,11 @@ void G_SetStats (edict_t *ent)
 	else
 	{
 		item = &itemlist[ent->client->ammo_index];
+/*freeze
 		ent->client->ps.stats[STAT_AMMO_ICON] = gi.imageindex (item->icon);
+freeze*/
+		ent->client->ps.stats[STAT_AMMO_ICON] = HudItemIcon (item);
+/*freeze*/
 		ent->client->ps.stats[STAT_AMMO] = ent->client->pers.inventory[ent->client->ammo_index];
 	}
 	
@@ -419,7 +505,13 @@ void G_SetStats (edict_t *ent)
 	power_armor_type = PowerArmorType (ent);
 	if (power_armor_type)
 	{
+/*freeze
 		cells = ent->client->pers.inventory[ITEM_INDEX(FindItem ("cells"))];
+freeze*/
+		if (!hud_cells)
+			hud_cells = ITEM_INDEX(FindItem ("cells"));
+		cells = ent->client->pers.inventory[hud_cells];
+/*freeze*/
 		if (cells == 0)
 		{	// ran out of cells for power armor
 			ent->flags &= ~FL_POWER_ARMOR;
@@ -429,15 +521,27 @@ void G_SetStats (edict_t *ent)
 	}
 
 	index = ArmorIndex (ent);
+/*freeze
 	if (power_armor_type && (!index || (level.framenum & 8) ) )
+freeze*/
+	if (power_armor_type && (!index || (BASEFRAME & 8) ) )
+/*freeze*/
 	{	// flash between power armor and other armor icon
+/*freeze
 		ent->client->ps.stats[STAT_ARMOR_ICON] = gi.imageindex ("i_powershield");
+freeze*/
+		ent->client->ps.stats[STAT_ARMOR_ICON] = HudImage (&hud_powershield, "i_powershield");
+/*freeze*/
 		ent->client->ps.stats[STAT_ARMOR] = cells;
 	}
 	else if (index)
 	{
 		item = GetItemByIndex (index);
+/*freeze
 		ent->client->ps.stats[STAT_ARMOR_ICON] = gi.imageindex (item->icon);
+freeze*/
+		ent->client->ps.stats[STAT_ARMOR_ICON] = HudItemIcon (item);
+/*freeze*/
 		ent->client->ps.stats[STAT_ARMOR] = ent->client->pers.inventory[index];
 	}
 	else
@@ -460,23 +564,55 @@ void G_SetStats (edict_t *ent)
 	//
 	if (ent->client->quad_framenum > level.framenum)
 	{
+/*freeze
 		ent->client->ps.stats[STAT_TIMER_ICON] = gi.imageindex ("p_quad");
+freeze*/
+		ent->client->ps.stats[STAT_TIMER_ICON] = HudImage (&hud_quad, "p_quad");
+/*freeze*/
+/*freeze
 		ent->client->ps.stats[STAT_TIMER] = (ent->client->quad_framenum - level.framenum)/10;
+freeze*/
+		ent->client->ps.stats[STAT_TIMER] = (ent->client->quad_framenum - level.framenum)/BASEFRAMES(10);
+/*freeze*/
 	}
 	else if (ent->client->invincible_framenum > level.framenum)
 	{
+/*freeze
 		ent->client->ps.stats[STAT_TIMER_ICON] = gi.imageindex ("p_invulnerability");
+freeze*/
+		ent->client->ps.stats[STAT_TIMER_ICON] = HudImage (&hud_invulnerability, "p_invulnerability");
+/*freeze*/
+/*freeze
 		ent->client->ps.stats[STAT_TIMER] = (ent->client->invincible_framenum - level.framenum)/10;
+freeze*/
+		ent->client->ps.stats[STAT_TIMER] = (ent->client->invincible_framenum - level.framenum)/BASEFRAMES(10);
+/*freeze*/
 	}
 	else if (ent->client->enviro_framenum > level.framenum)
 	{
+/*freeze
 		ent->client->ps.stats[STAT_TIMER_ICON] = gi.imageindex ("p_envirosuit");
+freeze*/
+		ent->client->ps.stats[STAT_TIMER_ICON] = HudImage (&hud_envirosuit, "p_envirosuit");
+/*freeze*/
+/*freeze
 		ent->client->ps.stats[STAT_TIMER] = (ent->client->enviro_framenum - level.framenum)/10;
+freeze*/
+		ent->client->ps.stats[STAT_TIMER] = (ent->client->enviro_framenum - level.framenum)/BASEFRAMES(10);
+/*freeze*/
 	}
 	else if (ent->client->breather_framenum > level.framenum)
 	{
+/*freeze
 		ent->client->ps.stats[STAT_TIMER_ICON] = gi.imageindex ("p_rebreather");
+freeze*/
+		ent->client->ps.stats[STAT_TIMER_ICON] = HudImage (&hud_rebreather, "p_rebreather");
+/*freeze*/
+/*freeze
 		ent->client->ps.stats[STAT_TIMER] = (ent->client->breather_framenum - level.framenum)/10;
+freeze*/
+		ent->client->ps.stats[STAT_TIMER] = (ent->client->breather_framenum - level.framenum)/BASEFRAMES(10);
+/*freeze*/
 	}
 	else
 	{
@@ -490,7 +626,11 @@ void G_SetStats (edict_t *ent)
 	if (ent->client->pers.selected_item == -1)
 		ent->client->ps.stats[STAT_SELECTED_ICON] = 0;
 	else
+/*freeze
 		ent->client->ps.stats[STAT_SELECTED_ICON] = gi.imageindex (itemlist[ent->client->pers.selected_item].icon);
+freeze*/
+		ent->client->ps.stats[STAT_SELECTED_ICON] = HudItemIcon (&itemlist[ent->client->pers.selected_item]);
+/*freeze*/
 
 	ent->client->ps.stats[STAT_SELECTED_ITEM] = ent->client->pers.selected_item;
 
@@ -523,17 +663,29 @@ void G_SetStats (edict_t *ent)
 	//
 	// help icon / current weapon if not shown
 	//
+/*freeze
 	if (ent->client->pers.helpchanged && (level.framenum&8) )
+freeze*/
+	if (ent->client->pers.helpchanged && (BASEFRAME&8) )
+/*freeze*/
+/*freeze
 		ent->client->ps.stats[STAT_HELPICON] = gi.imageindex ("i_help");
+freeze*/
+		ent->client->ps.stats[STAT_HELPICON] = HudImage (&hud_help, "i_help");
+/*freeze*/
 	else if ( (ent->client->pers.hand == CENTER_HANDED || ent->client->ps.fov > 91)
 		&& ent->client->pers.weapon)
+/*freeze
 		ent->client->ps.stats[STAT_HELPICON] = gi.imageindex (ent->client->pers.weapon->icon);
+freeze*/
+		ent->client->ps.stats[STAT_HELPICON] = HudItemIcon (ent->client->pers.weapon);
+/*freeze*/
 	else
 		ent->client->ps.stats[STAT_HELPICON] = 0;
 
 	ent->client->ps.stats[STAT_SPECTATOR] = 0;
 /*freeze*/
-	playerStat(ent);
+	playerStat(ent, hud_stats[ent->client->resp.arena]);
 /*freeze*/
 }
 
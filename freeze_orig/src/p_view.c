@@ -33,6 +33,21 @@ float	bobmove;
 int		bobcycle;		// odd cycles are right foot going forward
 float	bobfracsin;		// sin(bobfrac*M_PI)
 
+/*freeze*/
+// the globals above as they were for each client, for the part of
+// ClientEndServerFrame that runs on the worker threads
+typedef struct
+{
+	vec3_t	forward, right, up;
+	float	xyspeed;
+	float	bobmove;
+	int		bobcycle;
+	float	bobfracsin;
+} viewframe_t;
+
+static	viewframe_t	viewframes[MAX_CLIENTS];
+/*freeze*/
+
 /*
 ===============
 SV_CalcRoll
@@ -226,6 +241,12 @@ void SV_CalcViewOffset (edict_t *ent)
 	float		ratio;
 	float		delta;
 	vec3_t		v;
+/*freeze*/
+	viewframe_t	*vf = &viewframes[ent - g_edicts - 1];
+	float		*forward = vf->forward, *right = vf->right;
+	float		xyspeed = vf->xyspeed, bobfracsin = vf->bobfracsin;
+	int			bobcycle = vf->bobcycle;
+/*freeze*/
 
 
 //===================================
@@ -350,6 +371,12 @@ void SV_CalcGunOffset (edict_t *ent)
 {
 	int		i;
 	float	delta;
+/*freeze*/
+	viewframe_t	*vf = &viewframes[ent - g_edicts - 1];
+	float		*forward = vf->forward, *right = vf->right, *up = vf->up;
+	float		xyspeed = vf->xyspeed, bobfracsin = vf->bobfracsin;
+	int			bobcycle = vf->bobcycle;
+/*freeze*/
 
 	// gun angles from bobbing
 	ent->client->ps.gunangles[ROLL] = xyspeed * bobfracsin * 0.005;
@@ -447,37 +474,61 @@ void SV_CalcBlend (edict_t *ent)
 	if (ent->client->quad_framenum > level.framenum)
 	{
 		remaining = ent->client->quad_framenum - level.framenum;
+/*freeze
 		if (remaining == 30)	// beginning to fade
 			gi.sound(ent, CHAN_ITEM, gi.soundindex("items/damage2.wav"), 1, ATTN_NORM, 0);
 		if (remaining > 30 || (remaining & 4) )
+freeze*/
+		if (remaining == BASEFRAMES(30))	// beginning to fade
+			gi.sound(ent, CHAN_ITEM, gi.soundindex("items/damage2.wav"), 1, ATTN_NORM, 0);
+		if (remaining > BASEFRAMES(30) || (remaining / framediv & 4) )
+/*freeze*/
 			SV_AddBlend (0, 0, 1, 0.08, ent->client->ps.blend);
 	}
 	else if (ent->client->invincible_framenum > level.framenum)
 	{
 		remaining = ent->client->invincible_framenum - level.framenum;
+/*freeze
 		if (remaining == 30)	// beginning to fade
 			gi.sound(ent, CHAN_ITEM, gi.soundindex("items/protect2.wav"), 1, ATTN_NORM, 0);
 		if (remaining > 30 || (remaining & 4) )
+freeze*/
+		if (remaining == BASEFRAMES(30))	// beginning to fade
+			gi.sound(ent, CHAN_ITEM, gi.soundindex("items/protect2.wav"), 1, ATTN_NORM, 0);
+		if (remaining > BASEFRAMES(30) || (remaining / framediv & 4) )
+/*freeze*/
 			SV_AddBlend (1, 1, 0, 0.08, ent->client->ps.blend);
 	}
 	else if (ent->client->enviro_framenum > level.framenum)
 	{
 		remaining = ent->client->enviro_framenum - level.framenum;
+/*freeze
 		if (remaining == 30)	// beginning to fade
 			gi.sound(ent, CHAN_ITEM, gi.soundindex("items/airout.wav"), 1, ATTN_NORM, 0);
 		if (remaining > 30 || (remaining & 4) )
+freeze*/
+		if (remaining == BASEFRAMES(30))	// beginning to fade
+			gi.sound(ent, CHAN_ITEM, gi.soundindex("items/airout.wav"), 1, ATTN_NORM, 0);
+		if (remaining > BASEFRAMES(30) || (remaining / framediv & 4) )
+/*freeze*/
 			SV_AddBlend (0, 1, 0, 0.08, ent->client->ps.blend);
 	}
 	else if (ent->client->breather_framenum > level.framenum)
 	{
 		remaining = ent->client->breather_framenum - level.framenum;
+/*freeze
 		if (remaining == 30)	// beginning to fade
 			gi.sound(ent, CHAN_ITEM, gi.soundindex("items/airout.wav"), 1, ATTN_NORM, 0);
 		if (remaining > 30 || (remaining & 4) )
+freeze*/
+		if (remaining == BASEFRAMES(30))	// beginning to fade
+			gi.sound(ent, CHAN_ITEM, gi.soundindex("items/airout.wav"), 1, ATTN_NORM, 0);
+		if (remaining > BASEFRAMES(30) || (remaining / framediv & 4) )
+/*freeze*/
 			SV_AddBlend (0.4, 1, 0.4, 0.04, ent->client->ps.blend);
 	}
 /*freeze*/
-	else if (ent->client->frozen && !ent->client->chase_target && (!ent->client->resp.thawer || level.framenum &8))
+	else if (ent->client->frozen && !ent->client->chase_target && (!ent->client->resp.thawer || BASEFRAME &8))
 	{
 		if (ent->client->resp.team == red)
 			SV_AddBlend(0.6, 0, 0, 0.4, ent->client->ps.blend);
@@ -499,12 +550,20 @@ void SV_CalcBlend (edict_t *ent)
 		SV_AddBlend (0.85, 0.7, 0.3, ent->client->bonus_alpha, ent->client->ps.blend);
 
 	// drop the damage value
+/*freeze
 	ent->client->damage_alpha -= 0.06;
+freeze*/
+	ent->client->damage_alpha -= 0.6 * FRAMETIME;
+/*freeze*/
 	if (ent->client->damage_alpha < 0)
 		ent->client->damage_alpha = 0;
 
 	// drop the bonus value
+/*freeze
 	ent->client->bonus_alpha -= 0.1;
+freeze*/
+	ent->client->bonus_alpha -= FRAMETIME;
+/*freeze*/
 	if (ent->client->bonus_alpha < 0)
 		ent->client->bonus_alpha = 0;
 }
@@ -678,7 +737,11 @@ void P_WorldEffects (void)
 		{
 			current_player->air_finished = level.time + 10;
 
+/*freeze
 			if (((int)(current_client->breather_framenum - level.framenum) % 25) == 0)
+freeze*/
+			if (((int)(current_client->breather_framenum - level.framenum) % BASEFRAMES(25)) == 0)
+/*freeze*/
 			{
 				if (!current_client->breather_sound)
 					gi.sound (current_player, CHAN_AUTO, gi.soundindex("player/u_breath1.wav"), 1, ATTN_NORM, 0);
@@ -726,7 +789,11 @@ void P_WorldEffects (void)
 	//
 	// check for sizzle damage
 	//
+/*freeze
 	if (waterlevel && (current_player->watertype&(CONTENTS_LAVA|CONTENTS_SLIME)) )
+freeze*/
+	if (waterlevel && (current_player->watertype&(CONTENTS_LAVA|CONTENTS_SLIME)) && ISBASEFRAME)
+/*freeze*/
 	{
 		if (current_player->watertype & CONTENTS_LAVA)
 		{
@@ -794,9 +861,13 @@ void G_SetClientEffects (edict_t *ent)
 	if (ent->client->quad_framenum > level.framenum)
 	{
 		remaining = ent->client->quad_framenum - level.framenum;
+/*freeze
 		if (remaining > 30 || (remaining & 4) )
+freeze*/
+		if (remaining > BASEFRAMES(30) || (remaining / framediv & 4) )
+/*freeze*/
 /*freeze*/
-		if (level.framenum &8)
+		if (BASEFRAME &8)
 			playerShell(ent, ent->client->resp.team);
 		else
 /*freeze*/
@@ -806,9 +877,13 @@ void G_SetClientEffects (edict_t *ent)
 	if (ent->client->invincible_framenum > level.framenum)
 	{
 		remaining = ent->client->invincible_framenum - level.framenum;
+/*freeze
 		if (remaining > 30 || (remaining & 4) )
+freeze*/
+		if (remaining > BASEFRAMES(30) || (remaining / framediv & 4) )
+/*freeze*/
 /*freeze*/
-		if (level.framenum &8)
+		if (BASEFRAME &8)
 /*freeze*/
 			ent->s.effects |= EF_PENT;
 	}
@@ -829,6 +904,13 @@ G_SetClientEvent
 */
 void G_SetClientEvent (edict_t *ent)
 {
+/*freeze*/
+	viewframe_t	*vf = &viewframes[ent - g_edicts - 1];
+	gclient_t	*current_client = ent->client;
+	float		xyspeed = vf->xyspeed, bobmove = vf->bobmove;
+	int			bobcycle = vf->bobcycle;
+
+/*freeze*/
 	if (ent->s.event)
 		return;
 
@@ -855,7 +937,11 @@ void G_SetClientSound (edict_t *ent)
 	}
 
 	// help beep (no more than three times)
+/*freeze
 	if (ent->client->pers.helpchanged && ent->client->pers.helpchanged <= 3 && !(level.framenum&63) )
+freeze*/
+	if (ent->client->pers.helpchanged && ent->client->pers.helpchanged <= 3 && !(level.framenum % BASEFRAMES(64)) )
+/*freeze*/
 	{
 		ent->client->pers.helpchanged++;
 		gi.sound (ent, CHAN_VOICE, gi.soundindex ("misc/pc_up.wav"), 1, ATTN_STATIC, 0);
@@ -888,6 +974,9 @@ void G_SetClientFrame (edict_t *ent)
 {
 	gclient_t	*client;
 	qboolean	duck, run;
+/*freeze*/
+	float		xyspeed = viewframes[ent - g_edicts - 1].xyspeed;
+/*freeze*/
 
 	if (ent->s.modelindex != 255)
 		return;		// not in the player model
@@ -911,6 +1000,12 @@ void G_SetClientFrame (edict_t *ent)
 	if (!ent->groundentity && client->anim_priority <= ANIM_WAVE)
 		goto newanim;
 
+/*freeze*/
+	// animations step every BASETIME whatever the frame rate
+	if (!ISBASEFRAME)
+		return;
+/*freeze*/
+
 	if(client->anim_priority == ANIM_REVERSE)
 	{
 		if(ent->s.frame > client->anim_end)
@@ -989,6 +1084,28 @@ and right after spawning
 */
 void ClientEndServerFrame (edict_t *ent)
 {
+/*freeze*/
+	G_CheckHud ();
+	if (P_BeginViewFrame (ent))
+	{
+		P_ViewFrame (0, &ent);
+		P_EndViewFrame (ent);
+	}
+}
+
+/*
+=================
+P_BeginViewFrame
+
+The part of ClientEndServerFrame that may call the engine or hurt the
+player, run for each client in turn.  Returns false if there is no view
+to calculate.
+=================
+*/
+qboolean P_BeginViewFrame (edict_t *ent)
+{
+	viewframe_t	*vf;
+/*freeze*/
 	float	bobtime;
 	int		i;
 
@@ -1024,13 +1141,20 @@ void ClientEndServerFrame (edict_t *ent)
 		current_client->ps.blend[3] = 0;
 		current_client->ps.fov = 90;
 		G_SetStats (ent);
+/*freeze
 		return;
+freeze*/
+		return false;
+/*freeze*/
 	}
 
 	AngleVectors (ent->client->v_angle, forward, right, up);
 
 	// burn from lava, etc
 	P_WorldEffects ();
+/*freeze*/
+	freezeShell (ent);
+/*freeze*/
 
 	//
 	// set model angles from view angles so other things in
@@ -1064,6 +1188,9 @@ void ClientEndServerFrame (edict_t *ent)
 		else
 			bobmove = 0.0625;
 	}
+/*freeze*/
+	bobmove /= framediv;
+/*freeze*/
 	
 	bobtime = (current_client->bobtime += bobmove);
 
@@ -1078,6 +1205,31 @@ void ClientEndServerFrame (edict_t *ent)
 
 	// apply all the damage taken this frame
 	P_DamageFeedback (ent);
+/*freeze*/
+
+	vf = &viewframes[ent - g_edicts - 1];
+	VectorCopy (forward, vf->forward);
+	VectorCopy (right, vf->right);
+	VectorCopy (up, vf->up);
+	vf->xyspeed = xyspeed;
+	vf->bobmove = bobmove;
+	vf->bobcycle = bobcycle;
+	vf->bobfracsin = bobfracsin;
+	return true;
+}
+
+/*
+=================
+P_ViewFrame
+
+The view calculations that only touch the player's own edict and client,
+for the edict at ((edict_t **)arg)[index].  Run for all the players at
+once on the worker threads, so nothing in here may call gi.*.
+=================
+*/
+void P_ViewFrame (int index, void *arg)
+{
+	edict_t	*ent = ((edict_t **)arg)[index];
 
 	// determine the view offsets
 	SV_CalcViewOffset (ent);
@@ -1085,6 +1237,23 @@ void ClientEndServerFrame (edict_t *ent)
 	// determine the gun offsets
 	SV_CalcGunOffset (ent);
 
+	G_SetClientEvent (ent);
+
+	G_SetClientEffects (ent);
+
+	G_SetClientFrame (ent);
+}
+
+/*
+=================
+P_EndViewFrame
+
+The rest of ClientEndServerFrame, back on the game thread in client order.
+=================
+*/
+void P_EndViewFrame (edict_t *ent)
+{
+/*freeze*/
 	// determine the full screen color blend
 	// must be after viewoffset, so eye contents can be
 	// accurately determined
@@ -1104,13 +1273,18 @@ void ClientEndServerFrame (edict_t *ent)
 		G_SetStats (ent);
 	G_CheckChaseStats(ent);
 
+/*freeze
 	G_SetClientEvent (ent);
 
 	G_SetClientEffects (ent);
 
+freeze*/
 	G_SetClientSound (ent);
+/*freeze
 
 	G_SetClientFrame (ent);
+freeze*/
+/*freeze*/
 
 	VectorCopy (ent->velocity, ent->client->oldvelocity);
 	VectorCopy (ent->client->ps.viewangles, ent->client->oldviewangles);
@@ -1120,10 +1294,14 @@ void ClientEndServerFrame (edict_t *ent)
 	VectorClear (ent->client->kick_angles);
 
 	// if the scoreboard is up, update it
+/*freeze
 	if (ent->client->showscores && !(level.framenum & 31) )
+freeze*/
+	if (ent->client->showscores && !(level.framenum % BASEFRAMES(32)) )
+/*freeze*/
 	{
 /*freeze*/
-		if (ent->client->menu)
+		if (ent->client->menu.entries)
 			pmenu_update(ent);
 		else
 /*freeze*/
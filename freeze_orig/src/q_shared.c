@@ -18,6 +18,19 @@ Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
 
 */
 #include "q_shared.h"
+/*freeze*/
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define	BOPS_SSE2
+#include <emmintrin.h>
+#elif defined __ARM_NEON || defined __ARM_NEON__
+#define	BOPS_NEON
+#include <arm_neon.h>
+#endif
+
+#ifdef __GLIBC__
+extern void sincos (double x, double *sin, double *cos);
+#endif
+/*freeze*/
 
 #define DEG2RAD( a ) ( a * M_PI ) / 180.0F
 
@@ -93,8 +106,30 @@ void RotatePointAroundVector( vec3_t dst, const vec3_t dir, const vec3_t point,
 void AngleVectors (vec3_t angles, vec3_t forward, vec3_t right, vec3_t up)
 {
 	float		angle;
+/*freeze
 	static float		sr, sp, sy, cr, cp, cy;
 	// static to help MS compiler fp bugs
+freeze*/
+	// not static, the worker threads call this too
+	float		sr, sp, sy, cr, cp, cy;
+#ifdef __GLIBC__
+	double		s, c;
+
+	// one sincos is cheaper than sin and cos when the compiler doesn't pair them itself
+	angle = angles[YAW] * (M_PI*2 / 360);
+	sincos (angle, &s, &c);
+	sy = s;
+	cy = c;
+	angle = angles[PITCH] * (M_PI*2 / 360);
+	sincos (angle, &s, &c);
+	sp = s;
+	cp = c;
+	angle = angles[ROLL] * (M_PI*2 / 360);
+	sincos (angle, &s, &c);
+	sr = s;
+	cr = c;
+#else
+/*freeze*/
 
 	angle = angles[YAW] * (M_PI*2 / 360);
 	sy = sin(angle);
@@ -105,6 +140,9 @@ void AngleVectors (vec3_t angles, vec3_t forward, vec3_t right, vec3_t up)
 	angle = angles[ROLL] * (M_PI*2 / 360);
 	sr = sin(angle);
 	cr = cos(angle);
+/*freeze*/
+#endif
+/*freeze*/
 
 	if (forward)
 	{
@@ -350,6 +388,15 @@ int BoxOnPlaneSide (vec3_t emins, vec3_t emaxs, struct cplane_s *p)
 {
 	float	dist1, dist2;
 	int		sides;
+/*freeze*/
+#ifdef BOPS_SSE2
+	__m128	n, mn, mx, neg, d1, d2, lo;
+#elif defined BOPS_NEON
+	float32x4_t	n, mn, mx, d1, d2;
+	uint32x4_t	neg;
+	float		b[8];
+#endif
+/*freeze*/
 
 // fast axial cases
 	if (p->type < 3)
@@ -362,6 +409,35 @@ int BoxOnPlaneSide (vec3_t emins, vec3_t emaxs, struct cplane_s *p)
 	}
 	
 // general case
+/*freeze*/
+	// pick the corners from the signs of the normal instead of switching
+	// on signbits, and add the products in the same order as the switch
+#ifdef BOPS_SSE2
+	n = _mm_setr_ps (p->normal[0], p->normal[1], p->normal[2], 0);
+	mn = _mm_setr_ps (emins[0], emins[1], emins[2], 0);
+	mx = _mm_setr_ps (emaxs[0], emaxs[1], emaxs[2], 0);
+	neg = _mm_cmplt_ps (n, _mm_setzero_ps ());
+	d1 = _mm_mul_ps (n, _mm_or_ps (_mm_and_ps (neg, mn), _mm_andnot_ps (neg, mx)));
+	d2 = _mm_mul_ps (n, _mm_or_ps (_mm_and_ps (neg, mx), _mm_andnot_ps (neg, mn)));
+	lo = _mm_unpacklo_ps (d1, d2);		// d1[0] d2[0] d1[1] d2[1]
+	lo = _mm_add_ps (lo, _mm_movehl_ps (lo, lo));
+	lo = _mm_add_ps (lo, _mm_unpackhi_ps (d1, d2));
+	dist1 = _mm_cvtss_f32 (lo);
+	dist2 = _mm_cvtss_f32 (_mm_shuffle_ps (lo, lo, _MM_SHUFFLE(1,1,1,1)));
+#elif defined BOPS_NEON
+	n = vld1q_f32 (p->normal);		// reads dist as the fourth lane
+	VectorCopy (emins, b);
+	VectorCopy (emaxs, b + 4);
+	b[3] = b[7] = 0;
+	mn = vld1q_f32 (b);
+	mx = vld1q_f32 (b + 4);
+	neg = vcltq_f32 (n, vdupq_n_f32 (0));
+	d1 = vmulq_f32 (n, vbslq_f32 (neg, mn, mx));
+	d2 = vmulq_f32 (n, vbslq_f32 (neg, mx, mn));
+	dist1 = vgetq_lane_f32 (d1, 0) + vgetq_lane_f32 (d1, 1) + vgetq_lane_f32 (d1, 2);
+	dist2 = vgetq_lane_f32 (d2, 0) + vgetq_lane_f32 (d2, 1) + vgetq_lane_f32 (d2, 2);
+#else
+/*freeze*/
 	switch (p->signbits)
 	{
 	case 0:
@@ -401,6 +477,9 @@ dist2 = p->normal[0]*emaxs[0] + p->normal[1]*emaxs[1] + p->normal[2]*emaxs[2];
 		assert( 0 );
 		break;
 	}
+/*freeze*/
+#endif
+/*freeze*/
 
 	sides = 0;
 	if (dist1 >= p->dist)
@@ -1220,8 +1299,94 @@ int Q_strcasecmp (char *s1, char *s2)
 
 
 
+/*freeze*/
+/*
+=================
+SB_Init
+
+The SB_ functions write straight into data and never past size.  They
+return false, and set overflowed, when what they were given had to be
+cut short.
+=================
+*/
+void SB_Init (strbuf_t *sb, char *data, int size)
+{
+	sb->data = data;
+	sb->size = size;
+	sb->len = 0;
+	sb->overflowed = false;
+	data[0] = 0;
+}
+
+qboolean SB_VPrintf (strbuf_t *sb, char *fmt, va_list argptr)
+{
+	int		room, len;
+
+	room = sb->size - sb->len;
+	len = vsnprintf (sb->data + sb->len, room, fmt, argptr);
+	if (len < 0 || len >= room)
+	{
+		sb->len = sb->size - 1;
+		sb->data[sb->len] = 0;
+		sb->overflowed = true;
+		return false;
+	}
+	sb->len += len;
+	return true;
+}
+
+qboolean SB_Printf (strbuf_t *sb, char *fmt, ...)
+{
+	va_list		argptr;
+	qboolean	fit;
+
+	va_start (argptr, fmt);
+	fit = SB_VPrintf (sb, fmt, argptr);
+	va_end (argptr);
+	return fit;
+}
+
+qboolean SB_Append (strbuf_t *sb, char *s)
+{
+	int		room, len;
+
+	room = sb->size - 1 - sb->len;
+	len = strlen (s);
+	if (len > room)
+	{
+		memcpy (sb->data + sb->len, s, room);
+		sb->len += room;
+		sb->data[sb->len] = 0;
+		sb->overflowed = true;
+		return false;
+	}
+	memcpy (sb->data + sb->len, s, len + 1);
+	sb->len += len;
+	return true;
+}
+
+/*
+=================
+SB_Truncate
+
+Goes back to the first len characters, as if nothing after them had been
+written, so a piece that didn't fit whole can be taken out again.
+=================
+*/
+void SB_Truncate (strbuf_t *sb, int len)
+{
+	if (len < sb->len)
+	{
+		sb->len = len;
+		sb->data[len] = 0;
+	}
+	sb->overflowed = false;
+}
+/*freeze*/
+
 void Com_sprintf (char *dest, int size, char *fmt, ...)
 {
+/*freeze
 	int		len;
 	va_list		argptr;
 	char	bigbuffer[0x10000];
@@ -1232,6 +1397,16 @@ void Com_sprintf (char *dest, int size, char *fmt, ...)
 	if (len >= size)
 		Com_Printf ("Com_sprintf: overflow of %i in %i\n", len, size);
 	strncpy (dest, bigbuffer, size-1);
+freeze*/
+	strbuf_t	sb;
+	va_list		argptr;
+
+	SB_Init (&sb, dest, size);
+	va_start (argptr,fmt);
+	if (!SB_VPrintf (&sb, fmt, argptr))
+		Com_Printf ("Com_sprintf: overflow in %i\n", size);
+	va_end (argptr);
+/*freeze*/
 }
 
 /*
@@ -220,6 +220,23 @@ char *COM_Parse (char **data_p);
 
 void Com_sprintf (char *dest, int size, char *fmt, ...);
 
+/*freeze*/
+// a string built up in place in a buffer of size, always 0 terminated
+typedef struct
+{
+	char		*data;
+	int			size;		// including the terminating 0
+	int			len;
+	qboolean	overflowed;	// something was cut short to fit
+} strbuf_t;
+
+void SB_Init (strbuf_t *sb, char *data, int size);
+qboolean SB_Printf (strbuf_t *sb, char *fmt, ...);
+qboolean SB_VPrintf (strbuf_t *sb, char *fmt, va_list argptr);
+qboolean SB_Append (strbuf_t *sb, char *s);
+void SB_Truncate (strbuf_t *sb, int len);
+/*freeze*/
+
 void Com_PageInMemory (byte *buffer, int size);
 
 //=============================================
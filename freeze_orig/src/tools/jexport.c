@@ -0,0 +1,224 @@
+// jexport.c -- converts match event journals to CSV or JSON Lines
+//
+// usage: jexport [-j] journal00.fjl [journal01.fjl ...]
+//
+// Files are put in the order they were created, so a whole rotation can be
+// passed with a wildcard.  Output goes to stdout, CSV unless -j is given.
+//
+// Stands alone, build with
+//	cl jexport.c
+//	cc -o jexport jexport.c
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../g_journal.h"
+
+#define	MAX_CLIENTS		256
+
+typedef struct
+{
+	char		*filename;
+	jheader_t	header;
+} jfile_t;
+
+static char *typenames[JE_NUMTYPES] =
+{
+	"dropped", "match", "end", "name", "leave", "team", "frag",
+	"freeze", "thaw", "melt", "break", "hook", "vote", "ready"
+};
+
+// matches team_enum in freeze.h
+static char *teamnames[] = {"red", "blue", "green", "yellow", "none"};
+
+// matches the MOD_* defines in g_local.h
+static char *modnames[] =
+{
+	"unknown", "blaster", "shotgun", "sshotgun", "machinegun", "chaingun",
+	"grenade", "g_splash", "rocket", "r_splash", "hyperblaster", "railgun",
+	"bfg_laser", "bfg_blast", "bfg_effect", "handgrenade", "hg_splash",
+	"water", "slime", "lava", "crush", "telefrag", "falling", "suicide",
+	"held_grenade", "explosive", "barrel", "bomb", "exit", "splash",
+	"target_laser", "trigger_hurt", "hit", "target_blaster"
+};
+
+static char	names[MAX_CLIENTS][17];
+static int	json;
+
+/*
+=================
+Clean
+
+Quake names use the high bit for colored text, strip it along with
+anything that would need quoting.
+=================
+*/
+static char *Clean (char *in, int len)
+{
+	static char	out[2][64];
+	static int	which;
+	char		*o;
+	int			i, c;
+
+	which ^= 1;
+	o = out[which];
+	for (i=0 ; i<len && in[i] ; i++)
+	{
+		c = in[i] & 127;
+		if (c < ' ' || c == '"' || c == '\\' || c == ',')
+			c = '_';
+		*o++ = c;
+	}
+	*o = 0;
+	return out[which];
+}
+
+static char *Team (int team)
+{
+	if (team < 0 || team >= (int)(sizeof(teamnames)/sizeof(teamnames[0])))
+		return "";
+	return teamnames[team];
+}
+
+static char *Name (int client)
+{
+	if (client == JE_NOCLIENT)
+		return "";
+	return Clean (names[client], 16);
+}
+
+static void Output (jevent_t *e)
+{
+	char	*type, *mod;
+	char	buf[16];
+
+	if (e->type < JE_NUMTYPES)
+		type = typenames[e->type];
+	else
+	{
+		sprintf (buf, "%d", e->type);
+		type = buf;
+	}
+
+	mod = "";
+	if ((e->type == JE_FRAG || e->type == JE_FREEZE)
+		&& e->arg >= 0 && e->arg < (int)(sizeof(modnames)/sizeof(modnames[0])))
+		mod = modnames[e->arg];
+
+	if (json)
+	{
+		printf ("{\"wallclock\":%d,\"time\":%d.%03d,\"event\":\"%s\",\"team\":\"%s\"",
+			e->wallclock, e->time / 1000, e->time % 1000, type, Team (e->team));
+		if (e->actor != JE_NOCLIENT)
+			printf (",\"actor\":%d,\"actor_name\":\"%s\"", e->actor, Name (e->actor));
+		if (e->target != JE_NOCLIENT)
+			printf (",\"target\":%d,\"target_name\":\"%s\"", e->target, Name (e->target));
+		printf (",\"arg\":%d,\"arg2\":%d", e->arg, e->arg2);
+		if (*mod)
+			printf (",\"mod\":\"%s\"", mod);
+		if (e->text[0])
+			printf (",\"text\":\"%s\"", Clean (e->text, sizeof(e->text)));
+		printf ("}\n");
+		return;
+	}
+
+	printf ("%d,%d.%03d,%s,%s,", e->wallclock, e->time / 1000, e->time % 1000, type, Team (e->team));
+	if (e->actor != JE_NOCLIENT)
+		printf ("%d,%s,", e->actor, Name (e->actor));
+	else
+		printf (",,");
+	if (e->target != JE_NOCLIENT)
+		printf ("%d,%s,", e->target, Name (e->target));
+	else
+		printf (",,");
+	printf ("%d,%d,%s,%s\n", e->arg, e->arg2, mod, Clean (e->text, sizeof(e->text)));
+}
+
+static void Export (jfile_t *jf)
+{
+	FILE		*f;
+	jheader_t	header;
+	jevent_t	e;
+
+	f = fopen (jf->filename, "rb");
+	if (!f || fread (&header, sizeof(header), 1, f) != 1)
+	{
+		fprintf (stderr, "couldn't read %s\n", jf->filename);
+		if (f)
+			fclose (f);
+		return;
+	}
+
+	while (fread (&e, sizeof(e), 1, f) == 1)
+	{
+		// names are carried in the events, so a file can be read on its own
+		if (e.type == JE_NAME && e.actor != JE_NOCLIENT)
+		{
+			memcpy (names[e.actor], e.text, sizeof(e.text));
+			names[e.actor][16] = 0;
+		}
+		Output (&e);
+		if (e.type == JE_LEAVE && e.actor != JE_NOCLIENT)
+			names[e.actor][0] = 0;
+	}
+	fclose (f);
+}
+
+static int CompareFiles (const void *a, const void *b)
+{
+	return ((jfile_t *)a)->header.created - ((jfile_t *)b)->header.created;
+}
+
+int main (int argc, char **argv)
+{
+	jfile_t	*files;
+	FILE	*f;
+	int		i, numfiles;
+
+	files = malloc (argc * sizeof(*files));
+	numfiles = 0;
+	for (i=1 ; i<argc ; i++)
+	{
+		if (!strcmp (argv[i], "-j"))
+		{
+			json = 1;
+			continue;
+		}
+
+		f = fopen (argv[i], "rb");
+		if (!f)
+		{
+			fprintf (stderr, "couldn't open %s\n", argv[i]);
+			continue;
+		}
+		if (fread (&files[numfiles].header, sizeof(jheader_t), 1, f) != 1
+			|| files[numfiles].header.magic != JOURNAL_MAGIC
+			|| files[numfiles].header.version != JOURNAL_VERSION
+			|| files[numfiles].header.eventsize != sizeof(jevent_t))
+		{
+			fprintf (stderr, "%s is not a version %d journal\n", argv[i], JOURNAL_VERSION);
+			fclose (f);
+			continue;
+		}
+		fclose (f);
+		files[numfiles].filename = argv[i];
+		numfiles++;
+	}
+
+	if (!numfiles)
+	{
+		fprintf (stderr, "usage: jexport [-j] journal00.fjl [journal01.fjl ...]\n");
+		return 1;
+	}
+
+	qsort (files, numfiles, sizeof(*files), CompareFiles);
+
+	if (!json)
+		printf ("wallclock,time,event,team,actor,actor_name,target,target_name,arg,arg2,mod,text\n");
+	for (i=0 ; i<numfiles ; i++)
+		Export (&files[i]);
+
+	free (files);
+	return 0;
+}